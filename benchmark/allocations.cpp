@@ -0,0 +1,75 @@
+#include "allocations.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local bool counting = false;
+thread_local std::size_t allocation_count = 0;
+thread_local std::size_t allocation_bytes = 0;
+
+void* counted_alloc(std::size_t size)
+{
+    if (counting)
+    {
+        ++allocation_count;
+        allocation_bytes += size;
+    }
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+}        // namespace
+
+AllocationScope::AllocationScope()
+{
+    allocation_count = 0;
+    allocation_bytes = 0;
+    counting = true;
+}
+
+AllocationScope::~AllocationScope()
+{
+    counting = false;
+}
+
+std::size_t AllocationScope::count() const
+{
+    return allocation_count;
+}
+
+std::size_t AllocationScope::bytes() const
+{
+    return allocation_bytes;
+}
+
+void* operator new(std::size_t size)
+{
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return counted_alloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
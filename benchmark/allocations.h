@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Counts heap allocations made by the current thread while in scope.
+ *
+ * Only allocations made on the constructing thread are counted, so work
+ * deferred to transport threads does not pollute the numbers.
+ */
+class AllocationScope
+{
+public:
+    AllocationScope();
+    ~AllocationScope();
+
+    std::size_t count() const;
+    std::size_t bytes() const;
+};
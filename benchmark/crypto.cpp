@@ -0,0 +1,94 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/QController.hpp>
+#include <qmedia/QSFrameContext.hpp>
+
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+constexpr std::size_t Crypto_Object_Count = 5000;
+constexpr std::size_t Crypto_Object_Size = 1200;
+constexpr std::uint64_t Crypto_Epoch = 1;
+
+const auto Crypto_Name = 0x00000101000001000000000000000000_name;
+
+/**
+ * @brief Protects and unprotects Crypto_Object_Count objects on each thread,
+ *        every thread on its own namespace as publications would be, all
+ *        through one shared context.
+ * @param serialized Hold one lock around every call, as the context used to
+ *                   for the whole AES operation.
+ * @param rotating Republish the keys every millisecond meanwhile, as epoch
+ *                 changes would.
+ * @returns Objects protected and unprotected per second over all threads.
+ */
+double run_threads(qmedia::QSFrameContext& context, std::size_t threads, bool serialized, bool rotating = false)
+{
+    std::mutex serial_mutex;
+    std::atomic<bool> done = false;
+    auto rotation = std::thread([&] {
+        while (rotating && !done)
+        {
+            context.addEpoch(Crypto_Epoch, quicr::bytes(16, 0x42));
+            context.enableEpoch(Crypto_Epoch);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    auto workers = std::vector<std::thread>();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t thread = 0; thread < threads; ++thread)
+    {
+        workers.emplace_back([&, thread] {
+            const auto quicr_namespace = quicr::Namespace(Crypto_Name | (thread << 48), 80);
+            auto buffer = quicr::bytes(Crypto_Object_Size + qmedia::QSFrameContext::Max_Tag_Size, 0xEF);
+            for (std::size_t i = 0; i < Crypto_Object_Count; ++i)
+            {
+                auto lock = serialized ? std::unique_lock(serial_mutex) : std::unique_lock<std::mutex>();
+                const auto ciphertext = context.protect(quicr_namespace, i, buffer, Crypto_Object_Size);
+                const auto received = sframe::output_bytes(buffer).first(ciphertext.size());
+                context.unprotect(Crypto_Epoch, quicr_namespace, i, received);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    done = true;
+    rotation.join();
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    return threads * Crypto_Object_Count / elapsed.count();
+}
+}        // namespace
+
+TEST_CASE("Crypto: protect and unprotect with a shared context")
+{
+    std::cout << Crypto_Object_Count << " objects of " << Crypto_Object_Size << " bytes per thread" << std::endl;
+    std::cout << std::left << std::setw(40) << "context" << std::right << std::setw(16) << "objects/sec"
+              << std::setw(12) << "scaling" << std::endl;
+
+    auto context = qmedia::QSFrameContext(qmedia::Default_Cipher_Suite);
+    context.addEpoch(Crypto_Epoch, quicr::bytes(16, 0x42));
+    context.enableEpoch(Crypto_Epoch);
+
+    for (const auto mode : {"locked", "shared", "shared, rotating keys"})
+    {
+        const auto serialized = mode == std::string("locked");
+        const auto rotating = mode == std::string("shared, rotating keys");
+        double single = 0;
+        for (const auto threads : {1, 2, 4, 8})
+        {
+            const auto objects_per_sec = run_threads(context, threads, serialized, rotating);
+            if (threads == 1) single = objects_per_sec;
+
+            const auto label = std::string(mode) + " " + std::to_string(threads) + " threads";
+            std::cout << std::left << std::setw(40) << label << std::right << std::setw(16) << std::fixed
+                      << std::setprecision(0) << objects_per_sec << std::setw(11) << std::setprecision(2)
+                      << objects_per_sec / single << "x" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <qmedia/QController.hpp>
+#include <qmedia/QDelegates.hpp>
+
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <atomic>
+
+// Minimal delegates that accept every manifest entry and count what arrives.
+
+class QSubscriptionBenchDelegate : public qmedia::QSubscriptionDelegate
+{
+public:
+    int prepare(const std::string& /* sourceId */,
+                const std::string& /* label */,
+                const qmedia::manifest::ProfileSet& /* profileSet */,
+                quicr::TransportMode& transportMode) override
+    {
+        transportMode = quicr::TransportMode::ReliablePerTrack;
+        return 0;
+    }
+
+    int update(const std::string& /* sourceId */,
+               const std::string& /* label */,
+               const qmedia::manifest::ProfileSet& /* profileSet */) override
+    {
+        return 1;
+    }
+
+    int subscribedObject(const quicr::Namespace& /* namespace */,
+                         quicr::bytes&& /* data */,
+                         std::uint32_t /* groupId */,
+                         std::uint16_t /* objectId */) override
+    {
+        ++received;
+        return 0;
+    }
+
+    std::atomic<std::size_t> received = 0;
+};
+
+class QSubscriberBenchDelegate : public qmedia::QSubscriberDelegate
+{
+public:
+    std::shared_ptr<qmedia::QSubscriptionDelegate>
+    allocateSubBySourceId(const std::string& /* sourceId */, const qmedia::manifest::ProfileSet& /* profileSet */) override
+    {
+        return std::make_shared<QSubscriptionBenchDelegate>();
+    }
+
+    int removeSubBySourceId(const std::string& /* sourceId */) override { return 0; }
+};
+
+class QPublicationBenchDelegate : public qmedia::QPublicationDelegate
+{
+public:
+    int prepare(const std::string& /* sourceId */,
+                const std::string& /* qualityProfile */,
+                quicr::TransportMode& transportMode) override
+    {
+        transportMode = quicr::TransportMode::ReliablePerGroup;
+        return 0;
+    }
+
+    int update(const std::string& /* sourceId */, const std::string& /* qualityProfile */) override { return 0; }
+
+    void publish(bool /* pubFlag */) override {}
+};
+
+class QPublisherBenchDelegate : public qmedia::QPublisherDelegate
+{
+public:
+    std::shared_ptr<qmedia::QPublicationDelegate> allocatePubByNamespace(const quicr::Namespace& /* quicrNamespace */,
+                                                                         const std::string& /* sourceID */,
+                                                                         const std::string& /* qualityProfile */,
+                                                                         const std::string& /* appTag */) override
+    {
+        return std::make_shared<QPublicationBenchDelegate>();
+    }
+
+    int removePubByNamespace(const quicr::Namespace& /* quicrNamespace */) override { return 0; }
+};
+
+inline std::shared_ptr<spdlog::logger> bench_logger()
+{
+    static const auto logger = [] {
+        auto logger = spdlog::stderr_color_mt("QBENCH");
+        logger->set_level(spdlog::level::warn);
+        return logger;
+    }();
+    return logger;
+}
+
+inline qmedia::QController make_bench_controller(bool encrypt)
+{
+    const auto suite = encrypt ? std::optional<sframe::CipherSuite>(qmedia::Default_Cipher_Suite) : std::nullopt;
+    return qmedia::QController(std::make_shared<QSubscriberBenchDelegate>(),
+                               std::make_shared<QPublisherBenchDelegate>(),
+                               bench_logger(),
+                               false,
+                               suite);
+}
+
+/**
+ * @brief Builds a publication for a camera with one profile per layer, laid
+ *        out like the simulcast manifests used by the tests.
+ */
+inline qmedia::manifest::MediaStream make_bench_stream(std::uint16_t camera, std::size_t layers)
+{
+    auto stream = qmedia::manifest::MediaStream{
+        .mediaType = "video",
+        .sourceName = "Camera " + std::to_string(camera),
+        .sourceId = std::to_string(camera),
+        .label = "Bench " + std::to_string(camera),
+        .profileSet = {.type = "simulcast", .profiles = {}},
+    };
+
+    for (std::size_t layer = 0; layer < layers; ++layer)
+    {
+        // pen=1, sub_pen=1, conference=1, mediatype=<layer>, endpoint=<camera>
+        const auto name = 0x00000101000001000000000000000000_name | (0x0_name | layer) << 64
+                          | (0x0_name | camera) << 48;
+        stream.profileSet.profiles.push_back({
+            .qualityProfile = "h264,width=1280,height=720,fps=30,br=1000",
+            .quicrNamespace = quicr::Namespace(name, 80),
+            .priorities = {2, 3},
+            .expiry = {500, 500},
+            .appTag = "",
+        });
+    }
+
+    return stream;
+}
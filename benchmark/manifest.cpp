@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+
+#include "allocations.h"
+#include "delegates.h"
+#include "relay.h"
+
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+struct ManifestCost
+{
+    double milliseconds;
+    double bytes_per_stream;
+    std::size_t keys;
+};
+
+/**
+ * @brief Imports a manifest that publishes and subscribes to the given
+ *        number of streams each, as a large meeting would. The time runs
+ *        until every key is derived, which happens in the background.
+ */
+ManifestCost update_manifest(std::size_t streams, bool encrypt)
+{
+    const auto relay = LocalhostRelay();
+    relay.run();
+
+    auto controller = make_bench_controller(encrypt);
+    qtransport::TransportConfig config{
+        .tls_cert_filename = "",
+        .tls_key_filename = "",
+    };
+    controller.connect(
+        "bench@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+
+    auto manifest = qmedia::manifest::Manifest{};
+    for (std::size_t camera = 1; camera <= streams; ++camera)
+    {
+        manifest.publications.push_back(make_bench_stream(static_cast<std::uint16_t>(camera), 1));
+        manifest.subscriptions.push_back(make_bench_stream(static_cast<std::uint16_t>(streams + camera), 1));
+    }
+
+    const auto scope = AllocationScope();
+    const auto start = std::chrono::steady_clock::now();
+    controller.updateManifest(manifest);
+    controller.awaitKeyWarmups();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    // Allocations on the warm-up thread aren't counted; the keys show what it holds.
+    return {
+        .milliseconds = elapsed.count(),
+        .bytes_per_stream = double(scope.bytes()) / (2 * streams),
+        .keys = controller.getKeyCount(),
+    };
+}
+}        // namespace
+
+TEST_CASE("Manifest: updateManifest time vs number of streams")
+{
+    std::cout << std::left << std::setw(40) << "streams" << std::right << std::setw(12) << "ms"
+              << std::setw(16) << "bytes/stream" << std::setw(10) << "keys" << std::endl;
+
+    for (const auto encrypt : {false, true})
+    {
+        const auto mode = std::string(encrypt ? "encrypted" : "unencrypted");
+        for (const auto streams : {10, 50, 200})
+        {
+            const auto cost = update_manifest(streams, encrypt);
+            std::cout << std::left << std::setw(40) << std::to_string(streams) + " (" + mode + ")" << std::right
+                      << std::setw(12) << std::fixed << std::setprecision(2) << cost.milliseconds << std::setw(16)
+                      << std::setprecision(0) << cost.bytes_per_stream << std::setw(10) << cost.keys << std::endl;
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <doctest/doctest.h>
+
+#include "delegates.h"
+#include "relay.h"
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr std::size_t Simulcast_Layers = 3;
+constexpr std::size_t Frame_Count = 300;
+
+// Roughly the frame sizes of 180p, 360p and 720p layers.
+constexpr std::size_t Layer_Object_Size[Simulcast_Layers] = {4 * 1024, 16 * 1024, 64 * 1024};
+
+struct PipelineResult
+{
+    double objects_per_sec;
+    std::uint64_t dropped;
+};
+
+/**
+ * @brief Publishes Frame_Count frames on every layer of every camera and
+ *        measures until the last object has been handed to the transport.
+ * @param threads Pipeline threads, 0 to encrypt on the publishing thread.
+ */
+PipelineResult publish_simulcast(std::size_t cameras, std::size_t threads)
+{
+    const auto relay = LocalhostRelay();
+    relay.run();
+
+    auto controller = make_bench_controller(true);
+    if (threads > 0)
+    {
+        controller.setPublishPipeline({
+            .worker_threads = threads,
+            .queue_capacity = Frame_Count,
+            .drop_policy = qmedia::PublishDropPolicy::drop_object,
+        });
+    }
+
+    qtransport::TransportConfig config{
+        .tls_cert_filename = "",
+        .tls_key_filename = "",
+    };
+    controller.connect("bench@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+
+    auto manifest = qmedia::manifest::Manifest{};
+    for (std::size_t camera = 0; camera < cameras; ++camera)
+    {
+        manifest.publications.push_back(make_bench_stream(static_cast<std::uint16_t>(camera + 1), Simulcast_Layers));
+    }
+    controller.updateManifest(manifest);
+    std::this_thread::sleep_for(1000ms);
+
+    auto handles = std::vector<qmedia::PublicationHandle>();
+    for (const auto& stream : manifest.publications)
+    {
+        for (const auto& profile : stream.profileSet.profiles)
+        {
+            handles.push_back(controller.getPublicationHandle(profile.quicrNamespace));
+        }
+    }
+
+    const auto sent = [&] {
+        std::uint64_t total = 0;
+        for (const auto& handle : handles)
+        {
+            const auto stats = controller.getPublicationStats(handle.quicrNamespace());
+            total += stats.sent + stats.dropped;
+        }
+        return total;
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t frame = 0; frame < Frame_Count; ++frame)
+    {
+        for (std::size_t i = 0; i < handles.size(); ++i)
+        {
+            const auto size = Layer_Object_Size[i % Simulcast_Layers];
+            auto buffer = controller.allocateObjectBuffer(handles[i], size);
+            std::fill(buffer.payload().begin(), buffer.payload().end(), static_cast<std::uint8_t>(frame));
+            controller.publishNamedObject(handles[i], std::move(buffer), frame % 30 == 0);
+        }
+    }
+
+    const auto total = Frame_Count * handles.size();
+    while (sent() < total)
+    {
+        std::this_thread::sleep_for(100us);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    std::uint64_t dropped = 0;
+    for (const auto& handle : handles)
+    {
+        dropped += controller.getPublicationStats(handle.quicrNamespace()).dropped;
+    }
+
+    return {.objects_per_sec = total / elapsed.count(), .dropped = dropped};
+}
+}        // namespace
+
+TEST_CASE("Publish: simulcast pipeline scaling")
+{
+    const auto cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << Simulcast_Layers << " layers per camera, " << Frame_Count << " frames, encrypted, " << cores
+              << " cores" << std::endl;
+    std::cout << std::left << std::setw(12) << "cameras" << std::setw(20) << "threads" << std::right
+              << std::setw(16) << "objects/sec" << std::setw(12) << "dropped" << std::endl;
+
+    for (const std::size_t cameras : {1, 2, 4})
+    {
+        auto thread_counts = std::vector<std::size_t>{0, 1, 2, 4};
+        if (cores > 4) thread_counts.push_back(cores);
+
+        for (const auto threads : thread_counts)
+        {
+            const auto result = publish_simulcast(cameras, threads);
+            std::cout << std::left << std::setw(12) << cameras << std::setw(20)
+                      << (threads ? std::to_string(threads) : std::string("inline")) << std::right
+                      << std::setw(16) << std::fixed << std::setprecision(0) << result.objects_per_sec
+                      << std::setw(12) << result.dropped << std::endl;
+        }
+    }
+}
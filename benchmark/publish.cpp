@@ -0,0 +1,187 @@
+#include <doctest/doctest.h>
+
+#include "allocations.h"
+#include "delegates.h"
+#include "relay.h"
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr std::size_t Object_Size = 64 * 1024;
+constexpr std::size_t Object_Count = 300;
+
+struct PublishCost
+{
+    double allocations;
+    double bytes;
+};
+
+template<typename Publish>
+PublishCost measure(Publish&& publish)
+{
+    AllocationScope scope;
+    for (std::size_t i = 0; i < Object_Count; ++i)
+    {
+        publish(i);
+    }
+
+    return {
+        .allocations = double(scope.count()) / Object_Count,
+        .bytes = double(scope.bytes()) / Object_Count,
+    };
+}
+
+void report(const std::string& label, const PublishCost& cost)
+{
+    std::cout << std::left << std::setw(40) << label << std::right << std::setw(12) << std::fixed
+              << std::setprecision(1) << cost.allocations << std::setw(16) << cost.bytes << std::endl;
+}
+
+void publish_copy_cost(bool encrypt)
+{
+    const auto relay = LocalhostRelay();
+    relay.run();
+
+    auto controller = make_bench_controller(encrypt);
+    qtransport::TransportConfig config{
+        .tls_cert_filename = "",
+        .tls_key_filename = "",
+    };
+    controller.connect("bench@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+
+    const auto media = make_bench_stream(1, 1);
+    const auto& ns = media.profileSet.profiles[0].quicrNamespace;
+    controller.updateManifest(qmedia::manifest::Manifest{.subscriptions = {}, .publications = {media}});
+    std::this_thread::sleep_for(1000ms);
+
+    const auto payload = quicr::bytes(Object_Size, 0xAB);
+
+    const auto pointer_cost = measure([&](std::size_t i) {
+        controller.publishNamedObject(ns, payload.data(), payload.size(), i % 30 == 0);
+    });
+
+    // Owned buffers are prepared up front, as an encoder would hand them over.
+    auto owned = std::vector<quicr::bytes>(Object_Count, payload);
+    const auto owned_cost = measure([&](std::size_t i) {
+        controller.publishNamedObject(ns, std::move(owned[i]), i % 30 == 0);
+    });
+
+    // Same again with method tracing, which is off for the bench controller.
+    auto traced = std::vector<quicr::bytes>(Object_Count, payload);
+    controller.setTracing(true);
+    const auto traced_cost = measure([&](std::size_t i) {
+        controller.publishNamedObject(ns, std::move(traced[i]), i % 30 == 0);
+    });
+    controller.setTracing(false);
+
+    // Encoders write straight into the allocated buffer, so the fill is not counted.
+    auto buffers = std::vector<qmedia::ObjectBuffer>();
+    for (std::size_t i = 0; i < Object_Count; ++i)
+    {
+        auto buffer = controller.allocateObjectBuffer(ns, payload.size());
+        std::copy(payload.begin(), payload.end(), buffer.payload().begin());
+        buffers.push_back(std::move(buffer));
+    }
+    const auto in_place_cost = measure([&](std::size_t i) {
+        controller.publishNamedObject(ns, std::move(buffers[i]), i % 30 == 0);
+    });
+
+    const auto mode = std::string(encrypt ? "encrypted" : "unencrypted");
+    report("pointer + length (" + mode + ")", pointer_cost);
+    report("quicr::bytes&& (" + mode + ")", owned_cost);
+    report("quicr::bytes&& traced (" + mode + ")", traced_cost);
+    report("ObjectBuffer&& (" + mode + ")", in_place_cost);
+}
+}        // namespace
+
+TEST_CASE("Publish: heap bytes per object")
+{
+    std::cout << "Object size " << Object_Size << " bytes, " << Object_Count << " objects" << std::endl;
+    std::cout << std::left << std::setw(40) << "overload" << std::right << std::setw(12) << "allocs/obj"
+              << std::setw(16) << "bytes/obj" << std::endl;
+
+    publish_copy_cost(false);
+    publish_copy_cost(true);
+}
+
+namespace
+{
+constexpr std::size_t Batch_Object_Size = 1200;
+constexpr std::size_t Batch_Object_Count = 30000;
+
+double publish_rate(qmedia::QController& controller,
+                    const std::vector<qmedia::PublicationHandle>& handles,
+                    std::size_t batch_size)
+{
+    const auto payload = quicr::bytes(Batch_Object_Size, 0xCD);
+    auto batch = std::vector<qmedia::PublishObject>();
+    batch.reserve(batch_size);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < Batch_Object_Count; ++i)
+    {
+        const auto& handle = handles[(i / batch_size) % handles.size()];
+        if (batch_size == 1)
+        {
+            controller.publishNamedObject(handle, quicr::bytes(payload), i % 30 == 0);
+            continue;
+        }
+
+        batch.push_back({handle, payload, i % 30 == 0});
+        if (batch.size() == batch_size)
+        {
+            controller.publishNamedObjects(batch);
+            batch.clear();
+        }
+    }
+    controller.publishNamedObjects(batch);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    return Batch_Object_Count / elapsed.count();
+}
+
+void publish_batch_throughput(bool encrypt)
+{
+    const auto relay = LocalhostRelay();
+    relay.run();
+
+    auto controller = make_bench_controller(encrypt);
+    qtransport::TransportConfig config{
+        .tls_cert_filename = "",
+        .tls_key_filename = "",
+    };
+    controller.connect("bench@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+
+    const auto media = make_bench_stream(1, 3);
+    controller.updateManifest(qmedia::manifest::Manifest{.subscriptions = {}, .publications = {media}});
+    std::this_thread::sleep_for(1000ms);
+
+    auto handles = std::vector<qmedia::PublicationHandle>();
+    for (const auto& profile : media.profileSet.profiles)
+    {
+        handles.push_back(controller.getPublicationHandle(profile.quicrNamespace));
+    }
+
+    const auto mode = std::string(encrypt ? "encrypted" : "unencrypted");
+    for (const auto batch_size : {1, 3, 8, 32})
+    {
+        std::cout << std::left << std::setw(40) << "batch " + std::to_string(batch_size) + " (" + mode + ")"
+                  << std::right << std::setw(16) << std::fixed << std::setprecision(0)
+                  << publish_rate(controller, handles, batch_size) << std::endl;
+    }
+}
+}        // namespace
+
+TEST_CASE("Publish: single vs batched throughput")
+{
+    std::cout << "Object size " << Batch_Object_Size << " bytes, " << Batch_Object_Count << " objects" << std::endl;
+    std::cout << std::left << std::setw(40) << "publish" << std::right << std::setw(16) << "objects/sec" << std::endl;
+
+    publish_batch_throughput(false);
+    publish_batch_throughput(true);
+}
@@ -0,0 +1,122 @@
+#include <doctest/doctest.h>
+
+#include "allocations.h"
+
+#include <qmedia/QController.hpp>
+#include <qmedia/QSFrameContext.hpp>
+
+#include <quicr/message_buffer.h>
+
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+constexpr std::size_t Receive_Object_Count = 1000;
+constexpr std::uint64_t Receive_Epoch = 1;
+
+struct ReceiveResult
+{
+    double objects_per_sec;
+    double allocations;
+};
+
+const auto Receive_Name = 0x00000101000001000000000000000000_name;
+
+/**
+ * @brief Objects as they arrive off the wire: [epoch][ciphertext][tag].
+ */
+std::vector<quicr::bytes> make_received(qmedia::QSFrameContext& context, std::size_t object_size)
+{
+    auto buf = quicr::messages::MessageBuffer();
+    buf << quicr::uintVar_t(Receive_Epoch);
+    const auto header = buf.take();
+
+    const auto plaintext = quicr::bytes(object_size, 0xEF);
+    auto objects = std::vector<quicr::bytes>();
+    for (std::size_t i = 0; i < Receive_Object_Count; ++i)
+    {
+        const auto name = Receive_Name | i;
+        auto wire = quicr::bytes(header.size() + object_size + qmedia::QSFrameContext::Max_Tag_Size);
+        std::copy(header.begin(), header.end(), wire.begin());
+        const auto ciphertext = context.protect(quicr::Namespace(name, 80),
+                                                name.bits<std::uint64_t>(0, 48),
+                                                sframe::output_bytes(wire).subspan(header.size()),
+                                                plaintext);
+        wire.resize(header.size() + ciphertext.size());
+        objects.push_back(std::move(wire));
+    }
+    return objects;
+}
+
+/**
+ * @brief Runs the receive step over every object on this thread.
+ * @param in_place Decrypt within the received buffer, else into a new one
+ *                 as the subscription did before.
+ */
+ReceiveResult receive(qmedia::QSFrameContext& context, std::vector<quicr::bytes> objects, bool in_place)
+{
+    std::size_t delivered = 0;
+    const auto scope = AllocationScope();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < objects.size(); ++i)
+    {
+        const auto name = Receive_Name | i;
+        auto& data = objects[i];
+        quicr::bytes output_buffer;
+        quicr::uintVar_t epoch;
+        if (in_place)
+        {
+            auto buf = quicr::messages::MessageBuffer(std::move(data));
+            buf >> epoch;
+            output_buffer = buf.take();
+            const auto cleartext = context.unprotect(
+                epoch, quicr::Namespace(name, 80), name.bits<std::uint64_t>(0, 48), output_buffer);
+            output_buffer.resize(cleartext.size());
+        }
+        else
+        {
+            auto buf = quicr::messages::MessageBuffer(data);
+            buf >> epoch;
+            const auto ciphertext = buf.take();
+            output_buffer = quicr::bytes(ciphertext.size());
+            const auto cleartext = context.unprotect(
+                epoch, quicr::Namespace(name, 80), name.bits<std::uint64_t>(0, 48), output_buffer, ciphertext);
+            output_buffer.resize(cleartext.size());
+        }
+        delivered += output_buffer.size();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    const auto allocations = double(scope.count()) / objects.size();
+    REQUIRE(delivered > 0);
+
+    return {
+        .objects_per_sec = objects.size() / elapsed.count(),
+        .allocations = allocations,
+    };
+}
+}        // namespace
+
+TEST_CASE("Receive: decrypted objects per second per core")
+{
+    std::cout << Receive_Object_Count << " objects per size, one thread" << std::endl;
+    std::cout << std::left << std::setw(40) << "decrypt" << std::right << std::setw(16) << "objects/sec"
+              << std::setw(12) << "allocs/obj" << std::endl;
+
+    auto context = qmedia::QSFrameContext(qmedia::Default_Cipher_Suite);
+    context.addEpoch(Receive_Epoch, quicr::bytes(16, 0x42));
+    context.enableEpoch(Receive_Epoch);
+
+    for (const auto object_size : {1200, 16 * 1024, 64 * 1024})
+    {
+        const auto objects = make_received(context, object_size);
+        for (const auto in_place : {false, true})
+        {
+            const auto result = receive(context, objects, in_place);
+            const auto label = std::string(in_place ? "in place " : "copy ") + std::to_string(object_size) + " bytes";
+            std::cout << std::left << std::setw(40) << label << std::right << std::setw(16) << std::fixed
+                      << std::setprecision(0) << result.objects_per_sec << std::setw(12) << std::setprecision(1)
+                      << result.allocations << std::endl;
+        }
+    }
+}
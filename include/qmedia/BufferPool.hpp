@@ -0,0 +1,77 @@
+#pragma once
+
+#include <quicr/quicr_common.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace qmedia
+{
+
+struct BufferPoolConfig
+{
+    // Capacities buffers are rounded up to. Requests larger than the last
+    // class are allocated exactly and never pooled, nor are released buffers
+    // over twice its capacity. Empty disables pooling.
+    std::vector<std::size_t> size_classes = {512, 2048, 8192, 32768, 131072, 524288};
+
+    // Idle buffers kept per size class; returns beyond this are freed.
+    std::size_t max_buffers_per_class = 64;
+};
+
+/**
+ * @brief Thread safe, size-classed pool of recycled object buffers.
+ *
+ * Buffers are plain quicr::bytes so they can be handed to the transport or the
+ * application; any buffer, wherever it came from, may be released back.
+ */
+class BufferPool
+{
+public:
+    struct Stats
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t releases;
+        std::uint64_t drops;
+        std::size_t pooled_bytes;
+        std::size_t high_water_bytes;
+    };
+
+    explicit BufferPool(const BufferPoolConfig& config = {});
+
+    /**
+     * @brief Get a buffer of exactly size bytes, reusing pooled storage when
+     *        a large enough buffer is available.
+     */
+    quicr::bytes acquire(std::size_t size);
+
+    /**
+     * @brief Return a buffer's storage to the pool.
+     */
+    void release(quicr::bytes&& buffer);
+
+    Stats stats() const;
+
+private:
+    struct SizeClass
+    {
+        std::size_t capacity;
+        std::mutex mutex;
+        std::vector<quicr::bytes> buffers;
+    };
+
+    const std::size_t max_buffers_per_class;
+    std::vector<SizeClass> classes;
+
+    std::atomic<std::uint64_t> hits = 0;
+    std::atomic<std::uint64_t> misses = 0;
+    std::atomic<std::uint64_t> releases = 0;
+    std::atomic<std::uint64_t> drops = 0;
+    std::atomic<std::size_t> pooled_bytes = 0;
+    std::atomic<std::size_t> high_water_bytes = 0;
+};
+
+}        // namespace qmedia
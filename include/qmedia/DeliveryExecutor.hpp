@@ -0,0 +1,64 @@
+#pragma once
+
+#include "qmedia/WorkStealingPool.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace qmedia
+{
+
+class SubscriptionDelegate;
+
+enum class DeliveryOverflowPolicy
+{
+    drop_oldest,        // Make room by dropping the longest queued object
+    drop_newest,        // Drop the object that did not fit
+    block,              // Hold the receiving thread until there is room
+};
+
+struct DeliveryExecutorConfig
+{
+    std::size_t threads = 2;
+    std::size_t queue_capacity = 256;        // Objects per subscription
+    DeliveryOverflowPolicy overflow_policy = DeliveryOverflowPolicy::drop_oldest;
+};
+
+struct DeliveryStats
+{
+    std::size_t queue_depth;
+    std::uint64_t delivered;
+    std::uint64_t dropped;
+    std::chrono::microseconds latency_total;        // From receipt to the application, summed
+    std::chrono::microseconds latency_max;
+};
+
+/**
+ * @brief Delivers received objects to the application off the transport
+ *        receive thread.
+ *
+ * Each attached subscription owns a bounded lock-free queue that is drained by
+ * at most one task at a time, so its objects stay in order, while a slow
+ * decoder for one subscription does not hold up receipt for the others.
+ */
+class DeliveryExecutor
+{
+public:
+    explicit DeliveryExecutor(const DeliveryExecutorConfig& config);
+    ~DeliveryExecutor();
+
+    const DeliveryExecutorConfig& getConfig() const { return config; }
+    std::size_t threadCount() const { return pool->size(); }
+
+    /**
+     * @brief Route a subscription's objects through the executor.
+     */
+    void attach(const std::shared_ptr<SubscriptionDelegate>& delegate);
+
+private:
+    const DeliveryExecutorConfig config;
+    std::shared_ptr<WorkStealingPool> pool;
+};
+
+}        // namespace qmedia
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace qmedia
+{
+
+/**
+ * @brief Remembers which objects of the most recent groups were received, so
+ *        objects replayed after a re-subscribe or relay failover are dropped.
+ *
+ * Each of the last Window_Groups groups has a bitmap of Window_Objects object
+ * IDs, which slides forward with the highest object received; objects further
+ * behind it, like groups older than the window, are reported as duplicates,
+ * since nothing is known about them any more. Group IDs are compared with
+ * serial number arithmetic. A group Restart_Groups or more behind the newest
+ * is taken for a publisher that restarted with lower IDs, and starts over.
+ *
+ * @note Not thread safe.
+ */
+class DuplicateFilter
+{
+public:
+    static constexpr std::size_t Window_Groups = 64;
+    static constexpr std::size_t Window_Objects = 512;
+    static constexpr std::uint32_t Restart_Groups = 1024;
+
+    /**
+     * @brief Records an object.
+     * @returns False if it was seen before, or it is too old to tell.
+     */
+    bool accept(std::uint32_t group_id, std::uint16_t object_id);
+
+    void reset();
+
+private:
+    static constexpr std::size_t Word_Bits = 64;
+
+    struct Group
+    {
+        std::uint32_t group_id = 0;
+        std::uint16_t first_object = 0;        // Lowest object ID in the bitmap
+        std::array<std::uint64_t, Window_Objects / Word_Bits> received = {};
+    };
+
+    static bool isNewer(std::uint32_t group_id, std::uint32_t than)
+    {
+        return static_cast<std::int32_t>(group_id - than) > 0;
+    }
+
+    std::optional<std::uint32_t> newest_group;
+    std::array<Group, Window_Groups> groups = {};
+};
+
+}        // namespace qmedia
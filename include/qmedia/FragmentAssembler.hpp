@@ -0,0 +1,141 @@
+#pragma once
+
+#include "qmedia/BufferPool.hpp"
+
+#include <quicr/quicr_common.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace qmedia
+{
+
+/**
+ * @brief Header in front of every fragment of a fragmented object.
+ *
+ * Each fragment is published as its own object with consecutive object ids,
+ * and encrypted on its own together with its header. The index locates the
+ * first fragment's object id, the length and offset place the fragment in the
+ * reassembled object.
+ */
+struct FragmentHeader
+{
+    static constexpr std::size_t Size = 10;
+
+    std::uint32_t object_length = 0;
+    std::uint32_t offset = 0;
+    std::uint16_t index = 0;
+
+    /**
+     * @brief Writes the header, big endian, into the first Size bytes.
+     */
+    void encode(std::span<std::uint8_t> buffer) const;
+
+    /**
+     * @brief Reads a header, or nullopt if the buffer is too short.
+     */
+    static std::optional<FragmentHeader> decode(std::span<const std::uint8_t> buffer);
+};
+
+struct FragmentAssemblerConfig
+{
+    std::size_t max_objects = 8;                             // Objects in flight; the oldest is evicted
+    std::size_t max_object_size = 4 * 1024 * 1024;           // Larger objects are rejected
+    std::size_t max_buffered_bytes = 16 * 1024 * 1024;       // Across all objects in flight
+    std::chrono::milliseconds timeout{1000};                 // Incomplete objects older than this are abandoned
+};
+
+struct FragmentAssemblerStats
+{
+    std::uint64_t reassembled;        // Objects completed
+    std::uint64_t abandoned;          // Incomplete objects evicted for space or time
+};
+
+/**
+ * @brief Reassembles fragmented objects into a single buffer per object,
+ *        allocated once when its first fragment arrives.
+ *
+ * Memory is bounded by the config: the oldest incomplete objects are
+ * abandoned to make room, and objects older than the timeout are abandoned
+ * when the next fragment arrives.
+ *
+ * @note Not thread safe; a subscription receives on one transport thread.
+ *       Only the stats may be read from other threads.
+ */
+class FragmentAssembler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FragmentAssembler(std::shared_ptr<BufferPool> bufferPool, const FragmentAssemblerConfig& config = {});
+
+    /**
+     * @brief Adds a fragment of an object of known length.
+     * @param object_key Identifies the object, e.g. group and first object id.
+     * @returns The object once all of its bytes arrived.
+     */
+    std::optional<quicr::bytes> add(std::uint64_t object_key,
+                                    std::size_t object_length,
+                                    std::size_t offset,
+                                    std::span<const std::uint8_t> fragment,
+                                    Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Adds a fragment of an object whose length is only known once its
+     *        last fragment arrives, as the transport delivers them.
+     *
+     * The buffer is sized from the fragment seen first and the size of the
+     * previous object, so it rarely has to grow.
+     *
+     * @returns The object once all of its bytes arrived.
+     */
+    std::optional<quicr::bytes> addTransportFragment(std::uint64_t object_key,
+                                                     std::size_t offset,
+                                                     bool last,
+                                                     std::span<const std::uint8_t> fragment,
+                                                     Clock::time_point now = Clock::now());
+
+    std::size_t inFlight() const { return objects.size(); }
+    std::size_t bufferedBytes() const { return buffered_bytes; }
+
+    FragmentAssemblerStats getStats() const;
+
+private:
+    struct PartialObject
+    {
+        std::uint64_t key;
+        quicr::bytes buffer;
+        std::size_t length = 0;                                  // 0 until the last fragment arrived
+        std::size_t received = 0;
+        std::vector<std::pair<std::size_t, std::size_t>> ranges;        // [begin, end) already copied in
+        Clock::time_point started;
+    };
+
+    using Iterator = std::deque<PartialObject>::iterator;
+
+    Iterator find(std::uint64_t object_key, std::size_t buffer_size, Clock::time_point now);
+    bool reserve(Iterator& object, std::size_t buffer_size);
+    std::optional<quicr::bytes> insert(Iterator object, std::size_t offset, std::span<const std::uint8_t> fragment);
+    void abandon(Iterator object);
+    void expire(Clock::time_point now);
+
+    const FragmentAssemblerConfig config;
+    std::shared_ptr<BufferPool> buffer_pool;
+
+    // Oldest first. Only a few objects are in flight, a scan is cheapest.
+    std::deque<PartialObject> objects;
+    std::size_t buffered_bytes = 0;
+    std::size_t last_object_size = 0;
+
+    std::atomic<std::uint64_t> reassembled = 0;
+    std::atomic<std::uint64_t> abandoned = 0;
+};
+
+}        // namespace qmedia
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace qmedia
+{
+
+/**
+ * @brief Estimates when each group of a subscription was due, so objects
+ *        delivered late, e.g. a backlog after a stall, can be told apart
+ *        from live ones although they carry no timestamp.
+ *
+ * The cadence is the median interval between recent groups starting to
+ * arrive, ignoring ones much shorter than it, as a backlog arrives in a
+ * burst. Groups are due a cadence apart from the last group that started
+ * on time, or at a steady pace again after a stall. A group is due to end
+ * when the next one is due to start. Group IDs are compared with serial
+ * number arithmetic; a group Restart_Groups or more behind the newest is
+ * taken for a publisher that restarted with lower IDs, and starts over.
+ *
+ * @note Not thread safe.
+ */
+class GroupClock
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t Cadence_Samples = 16;
+    static constexpr std::size_t Min_Cadence_Samples = 4;
+    static constexpr std::uint32_t Restart_Groups = 1024;
+
+    /**
+     * @brief Records an object's arrival.
+     * @returns How long after its group was due to end the object arrived,
+     *          negative if before; zero while the cadence is not known.
+     */
+    Clock::duration lateness(std::uint32_t group_id, Clock::time_point now);
+
+    void reset();
+
+private:
+    void startGroup(std::uint32_t group_id, Clock::time_point now);
+
+    static bool isNewer(std::uint32_t group_id, std::uint32_t than)
+    {
+        return static_cast<std::int32_t>(group_id - than) > 0;
+    }
+
+    std::optional<std::uint32_t> newest_group;
+    Clock::time_point newest_start;
+
+    // Last group found live, later ones are due a cadence apart from it.
+    std::uint32_t anchor_group = 0;
+    Clock::time_point anchor_start;
+
+    std::array<Clock::duration, Cadence_Samples> intervals = {};
+    std::size_t interval_count = 0;
+    Clock::duration cadence = {};
+    Clock::duration last_interval = {};
+};
+
+}        // namespace qmedia
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace qmedia
+{
+
+/**
+ * @brief Counts of a Histogram at one point in time.
+ *
+ * Bucket 0 holds zeros and bucket i holds values in [2^(i-1), 2^i); the last
+ * bucket also holds everything larger.
+ */
+struct HistogramSnapshot
+{
+    static constexpr std::size_t Bucket_Count = 32;
+
+    std::array<std::uint64_t, Bucket_Count> buckets = {};
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+
+    static std::uint64_t upperBound(std::size_t bucket)
+    {
+        if (bucket + 1 >= Bucket_Count) return std::numeric_limits<std::uint64_t>::max();
+        return (std::uint64_t(1) << bucket) - 1;
+    }
+
+    double mean() const { return count ? double(sum) / count : 0.0; }
+
+    /**
+     * @brief Upper bound of the bucket holding the given fraction (0 to 1) of
+     *        the values, or 0 when empty.
+     */
+    std::uint64_t percentile(double fraction) const
+    {
+        const auto rank = static_cast<std::uint64_t>(std::clamp(fraction, 0.0, 1.0) * count);
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < Bucket_Count; ++bucket)
+        {
+            seen += buckets[bucket];
+            if (seen > 0 && seen >= rank) return upperBound(bucket);
+        }
+        return 0;
+    }
+
+    HistogramSnapshot& operator+=(const HistogramSnapshot& other)
+    {
+        for (std::size_t bucket = 0; bucket < Bucket_Count; ++bucket) buckets[bucket] += other.buckets[bucket];
+        count += other.count;
+        sum += other.sum;
+        return *this;
+    }
+};
+
+/**
+ * @brief Power of two histogram that one thread records into while others
+ *        take snapshots, without locks.
+ *
+ * Counters are relaxed, so a snapshot taken while recording may be off by the
+ * values in flight but never blocks the recording thread.
+ */
+class Histogram
+{
+public:
+    void record(std::uint64_t value)
+    {
+        const auto bucket = std::min<std::size_t>(std::bit_width(value), HistogramSnapshot::Bucket_Count - 1);
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    HistogramSnapshot snapshot() const
+    {
+        HistogramSnapshot snapshot;
+        for (std::size_t bucket = 0; bucket < HistogramSnapshot::Bucket_Count; ++bucket)
+        {
+            snapshot.buckets[bucket] = buckets[bucket].load(std::memory_order_relaxed);
+            snapshot.count += snapshot.buckets[bucket];
+        }
+        snapshot.sum = sum.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, HistogramSnapshot::Bucket_Count> buckets = {};
+    std::atomic<std::uint64_t> sum = 0;
+};
+
+}        // namespace qmedia
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace qmedia
+{
+
+struct LayerAdaptationConfig
+{
+    // How often subscription stats are sampled.
+    std::chrono::milliseconds interval = std::chrono::milliseconds(500);
+
+    // Share of objects lost (gaps) above which a sample counts against the layer.
+    double down_loss = 0.05;
+
+    // Share of objects lost below which a sample counts as clean.
+    double up_loss = 0.01;
+
+    // A sample also counts against the layer when less than this share of its
+    // bitrate arrived. Zero ignores throughput.
+    double down_throughput = 0.5;
+
+    // Consecutive bad samples before stepping down a layer.
+    std::size_t down_samples = 2;
+
+    // Clean time needed before stepping up a layer, also the minimum time
+    // between switches.
+    std::chrono::milliseconds up_hold = std::chrono::seconds(10);
+
+    // Give up on a switch if the new layer does not start a group in time.
+    std::chrono::milliseconds switch_timeout = std::chrono::seconds(5);
+};
+
+struct LayerSample
+{
+    double loss;                   // Share of objects lost over the interval
+    double throughput_kbps;        // Received over the interval
+};
+
+/**
+ * @brief Decides which layer of a profile set to receive, from loss and
+ *        throughput samples.
+ *
+ * Layers are ordered by bitrate, lowest first. Stepping down takes a few bad
+ * samples in a row; stepping up takes a long clean stretch, so the receiver
+ * does not flap between layers.
+ *
+ * @note Not thread safe.
+ */
+class LayerAdaptation
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LayerAdaptation(const LayerAdaptationConfig& config,
+                    std::vector<std::uint32_t> bitrates,
+                    std::size_t initial_layer,
+                    Clock::time_point now);
+
+    /**
+     * @brief Feeds a sample of the current layer.
+     * @returns The layer to switch to, if any.
+     */
+    std::optional<std::size_t> update(const LayerSample& sample, Clock::time_point now);
+
+    /**
+     * @brief Records that the receiver moved to a layer.
+     */
+    void switched(std::size_t layer, Clock::time_point now);
+
+    /**
+     * @brief Highest layer the receiver may use.
+     */
+    void setMaxLayer(std::size_t layer);
+
+    std::size_t getMaxLayer() const { return max_layer; }
+    std::size_t getLayer() const { return layer; }
+    std::size_t layerCount() const { return bitrates.size(); }
+
+private:
+    const LayerAdaptationConfig config;
+    const std::vector<std::uint32_t> bitrates;        // kbps per layer, 0 if unknown
+
+    std::size_t layer;
+    std::size_t max_layer;
+    std::size_t bad_samples = 0;
+    Clock::time_point clean_since;
+};
+
+}        // namespace qmedia
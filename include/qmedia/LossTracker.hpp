@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace qmedia
+{
+
+struct LossTrackerConfig
+{
+    // Most recent groups tracked; an older group is settled when it leaves.
+    std::size_t groups = 16;
+
+    // How long a missing object may be outstanding before its group is
+    // reported incomplete.
+    std::chrono::milliseconds reorder_window = std::chrono::milliseconds(100);
+};
+
+struct LossStats
+{
+    std::uint64_t groups;                   // Groups with at least one object received
+    std::uint64_t lost_objects;             // Missing from reported groups, less those recovered
+    std::uint64_t lost_groups;              // Group IDs skipped entirely
+    std::uint64_t reordered;                // Arrived after a later object of its group
+    std::uint64_t recovered;                // Arrived after their group was reported incomplete
+    std::uint64_t incomplete_groups;        // Groups reported incomplete
+};
+
+/**
+ * @brief Counts lost, reordered and recovered objects over the most recent
+ *        groups, and reports groups that are missing objects.
+ *
+ * Each tracked group records the ranges of object IDs received, so holes are
+ * found however groups interleave, and an object seen twice counts once.
+ * Group IDs are compared with serial number arithmetic, so they may wrap. A
+ * group Restart_Groups or more away from the newest, either way, is taken for
+ * a publisher that restarted, and tracking starts over without counting loss.
+ * Each hole is reported once it has been open for the reorder window, or when
+ * its group leaves the window, so a hole opening after its group was reported
+ * is reported too. Objects missing from the end of a group cannot be seen and
+ * are not counted.
+ *
+ * @note Not thread safe. Only the stats may be read from other threads.
+ */
+class LossTracker
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::uint32_t Restart_Groups = 1024;
+
+    LossTracker(const LossTrackerConfig& config = {});
+
+    /**
+     * @brief Records a received object.
+     * @param incomplete IDs of groups with holes newly reported are appended,
+     *        each group at most once per call.
+     */
+    void add(std::uint32_t group_id,
+             std::uint16_t object_id,
+             Clock::time_point now,
+             std::vector<std::uint32_t>& incomplete);
+
+    /**
+     * @brief Match the wait of a reorder buffer in front of the decoder, so a
+     *        group is reported when the buffer gives up on it.
+     */
+    void setReorderWindow(std::chrono::milliseconds window) { config.reorder_window = window; }
+
+    LossStats getStats() const;
+
+private:
+    // Objects [begin, end) were received; the hole in front of them, from
+    // the previous range or the group's first object, has its own state.
+    struct Range
+    {
+        std::uint32_t begin;
+        std::uint32_t end;
+        Clock::time_point hole_since;
+        bool hole_reported = false;
+    };
+
+    struct Group
+    {
+        std::uint32_t group_id;
+        std::uint32_t first_object = 0;                     // Objects before it are not expected
+        std::vector<Range> received = {};                   // Ascending, none for a skipped group
+        std::optional<Clock::time_point> hole_since = {};   // Oldest hole not reported, if any
+        bool reported = false;                              // Counted in incomplete_groups
+
+        std::uint32_t holeBefore(std::size_t range) const;
+    };
+
+    static bool isNewer(std::uint32_t group_id, std::uint32_t than)
+    {
+        return static_cast<std::int32_t>(group_id - than) > 0;
+    }
+
+    /**
+     * @brief Settles the tracked groups and forgets the stream's position.
+     */
+    void restart(std::vector<std::uint32_t>& incomplete);
+
+    Group* find(std::uint32_t group_id);
+    void track(Group&& group, std::vector<std::uint32_t>& incomplete);
+    void receive(Group& group, std::uint32_t object_id, Clock::time_point now);
+
+    /**
+     * @brief Reports the holes open for the reorder window, or all of them
+     *        when settling a group.
+     */
+    void report(Group& group, Clock::time_point now, bool settle, std::vector<std::uint32_t>& incomplete);
+
+    LossTrackerConfig config;
+
+    std::vector<Group> tracked;        // Oldest first
+    std::optional<std::uint32_t> newest_group;
+
+    std::atomic<std::uint64_t> group_count = 0;
+    std::atomic<std::uint64_t> lost_objects = 0;
+    std::atomic<std::uint64_t> lost_groups = 0;
+    std::atomic<std::uint64_t> reordered = 0;
+    std::atomic<std::uint64_t> recovered = 0;
+    std::atomic<std::uint64_t> incomplete_groups = 0;
+};
+
+}        // namespace qmedia
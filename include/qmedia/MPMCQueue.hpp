@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace qmedia
+{
+
+/**
+ * @brief Bounded, lock-free multi-producer multi-consumer ring buffer.
+ *
+ * Each slot carries a sequence number that tells producers and consumers
+ * whose turn it is, so any thread may push or pop. This lets a producer make
+ * room by popping the oldest value itself while a consumer is draining.
+ */
+template<typename T>
+class MPMCQueue
+{
+public:
+    explicit MPMCQueue(std::size_t capacity) : mask(round_up(capacity) - 1), slots(new Slot[mask + 1])
+    {
+        for (std::size_t i = 0; i <= mask; ++i)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    /**
+     * @brief Push from any thread. On failure (queue full) value is left
+     *        untouched.
+     */
+    bool push(T&& value)
+    {
+        auto position = write_index.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+        {
+            slot = &slots[position & mask];
+            const auto sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (diff == 0)
+            {
+                if (write_index.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = write_index.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop from any thread.
+     */
+    std::optional<T> pop()
+    {
+        auto position = read_index.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+        {
+            slot = &slots[position & mask];
+            const auto sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (diff == 0)
+            {
+                if (read_index.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0)
+            {
+                return std::nullopt;
+            }
+            else
+            {
+                position = read_index.load(std::memory_order_relaxed);
+            }
+        }
+
+        auto value = std::move(slot->value);
+        slot->value = T{};
+        slot->sequence.store(position + mask + 1, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * @brief Approximate while other threads push or pop.
+     */
+    std::size_t size() const
+    {
+        const auto read = read_index.load(std::memory_order_acquire);
+        const auto write = write_index.load(std::memory_order_acquire);
+        return write > read ? write - read : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    static std::size_t round_up(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+    // Keep the indices on separate cache lines to avoid false sharing.
+    static constexpr std::size_t Cache_Line_Size = 64;
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    const std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(Cache_Line_Size) std::atomic<std::size_t> write_index = 0;
+    alignas(Cache_Line_Size) std::atomic<std::size_t> read_index = 0;
+};
+
+}        // namespace qmedia
@@ -3,6 +3,7 @@
 #include <qname>
 #include <nlohmann/json.hpp>
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -24,6 +25,26 @@ struct Profile
     friend bool operator==(const Profile& lhs, const Profile& rhs);
 };
 
+/**
+ * @brief Fields of a qualityProfile string, e.g.
+ *        "h264,width=1280,height=720,fps=30,br=1000,frag=1200". Missing or
+ *        malformed values are left at 0.
+ *
+ * The publisher splits objects into fragments of frag bytes, and subscribers
+ * reassemble them, so both sides follow the profile of the publication.
+ */
+struct QualityProfile
+{
+    std::string codec;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t fps = 0;
+    std::uint32_t bitrate = 0;              // kbps
+    std::uint32_t fragment_size = 0;        // Bytes, 0 if objects are not fragmented
+
+    static QualityProfile parse(const std::string& qualityProfile);
+};
+
 struct ProfileSet
 {
     std::string type;
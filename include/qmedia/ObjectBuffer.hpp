@@ -0,0 +1,63 @@
+#pragma once
+
+#include <quicr/quicr_common.h>
+
+#include <cstdint>
+#include <span>
+
+namespace qmedia
+{
+
+/**
+ * @brief Buffer for an object to be published, with headroom reserved in
+ *        front of the payload for the SFrame epoch header and behind it for
+ *        the AEAD tag.
+ *
+ * The payload is encrypted in place, so the storage becomes the wire buffer
+ * handed to the transport without any further allocation or copy. Obtain one
+ * from QController::allocateObjectBuffer so the headroom matches the
+ * publication.
+ */
+class ObjectBuffer
+{
+public:
+    ObjectBuffer() = default;
+    ObjectBuffer(std::size_t header_size, std::size_t payload_size, std::size_t trailer_size);
+
+    /**
+     * @brief Wraps existing storage, growing it if it is too small for the
+     *        requested layout.
+     */
+    ObjectBuffer(quicr::bytes&& storage, std::size_t header_size, std::size_t payload_size, std::size_t trailer_size);
+
+    /**
+     * @brief The writable payload region.
+     */
+    std::span<std::uint8_t> payload() { return {storage.data() + header_size, payload_size}; }
+    std::span<const std::uint8_t> payload() const { return {storage.data() + header_size, payload_size}; }
+
+    /**
+     * @brief Shrinks or grows the payload within the capacity that was
+     *        allocated. Returns false if the requested size does not fit.
+     */
+    bool resize(std::size_t size);
+
+    std::size_t size() const { return payload_size; }
+    std::size_t capacity() const { return storage.size() - header_size - trailer_size; }
+    std::size_t headerSize() const { return header_size; }
+    std::size_t trailerSize() const { return trailer_size; }
+    bool empty() const { return payload_size == 0; }
+
+    /**
+     * @brief Gives up the underlying storage, header and trailer included.
+     */
+    quicr::bytes release() &&;
+
+private:
+    quicr::bytes storage;
+    std::size_t header_size = 0;
+    std::size_t trailer_size = 0;
+    std::size_t payload_size = 0;
+};
+
+}        // namespace qmedia
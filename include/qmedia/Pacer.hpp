@@ -0,0 +1,121 @@
+#pragma once
+
+#include "qmedia/TraceBuffer.hpp"
+
+#include <quicr/quicr_client.h>
+#include <quicr/quicr_common.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qmedia
+{
+
+class PublicationDelegate;
+
+struct PacerConfig
+{
+    // Objects are released at this multiple of the profile bitrate, so the
+    // pacer smooths bursts without holding media back on average.
+    double pacing_factor = 2.5;
+
+    // Bytes that may go out back to back, as time at the paced rate.
+    std::chrono::milliseconds burst = std::chrono::milliseconds(20);
+
+    // Audio is small and latency sensitive, it skips the pacer by default.
+    bool pace_audio = false;
+};
+
+/**
+ * @brief Token bucket that computes when an object may be released.
+ *
+ * Tokens may go negative: an object that does not fit is scheduled for when
+ * the bucket will have refilled, and later objects queue up behind it. They
+ * are never scheduled before an earlier object, also when the rate went up
+ * in between. At a rate of 0 objects are not paced, but still kept in order.
+ * @note Not thread safe.
+ */
+class TokenBucket
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket(double bytes_per_second, std::chrono::microseconds burst);
+
+    void setRate(double bytes_per_second);
+    double getRate() const { return rate; }
+
+    /**
+     * @brief Takes size bytes from the bucket.
+     * @returns When the object may be sent; now if it fits in the bucket.
+     */
+    Clock::time_point schedule(std::size_t size, Clock::time_point now);
+
+private:
+    void refill(Clock::time_point now);
+
+    double rate;
+    std::chrono::microseconds burst;
+    double capacity;
+    double tokens;
+    Clock::time_point last_refill;
+    Clock::time_point last_release;
+};
+
+/**
+ * @brief An object waiting in the pacer.
+ */
+struct PacedObject
+{
+    TokenBucket::Clock::time_point release_time;
+    TokenBucket::Clock::time_point queued_time;
+    std::uint64_t sequence = 0;
+
+    std::shared_ptr<PublicationDelegate> publication;
+    std::shared_ptr<quicr::Client> client;
+    quicr::Name name;
+    std::uint8_t priority = 0;
+    std::uint16_t expiry = 0;
+    quicr::bytes data;
+    TraceBuffer trace;
+};
+
+/**
+ * @brief Controller thread that hands paced objects to the transport at
+ *        their release time, in release order.
+ */
+class PacedSender
+{
+public:
+    PacedSender();
+    ~PacedSender();
+
+    PacedSender(const PacedSender&) = delete;
+    PacedSender& operator=(const PacedSender&) = delete;
+
+    void enqueue(PacedObject&& object);
+
+    /**
+     * @brief Stops the thread. Objects still waiting are discarded.
+     */
+    void stop();
+
+    std::size_t size() const;
+
+private:
+    void run();
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<PacedObject> heap;        // Min-heap on release time, then sequence
+    std::uint64_t next_sequence = 0;
+    bool stopping = false;
+    std::thread thread;
+};
+
+}        // namespace qmedia
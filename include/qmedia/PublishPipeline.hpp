@@ -0,0 +1,53 @@
+#pragma once
+
+#include "qmedia/WorkStealingPool.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace qmedia
+{
+
+class PublicationDelegate;
+
+enum class PublishDropPolicy
+{
+    drop_object,        // Drop only the object that did not fit
+    drop_group,         // Drop it and the rest of its group, until the next group starts
+};
+
+struct PublishPipelineConfig
+{
+    std::size_t worker_threads = 0;          // 0 selects one thread per core
+    std::size_t queue_capacity = 256;        // Objects per publication
+    PublishDropPolicy drop_policy = PublishDropPolicy::drop_group;
+};
+
+/**
+ * @brief Encrypts and sends published objects off the caller's thread.
+ *
+ * Each attached publication owns an SPSC queue that is drained by at most one
+ * task at a time, so its objects stay in order, while different publications
+ * (e.g. the simulcast layers of a camera) are encrypted in parallel on a
+ * work-stealing pool.
+ */
+class PublishPipeline
+{
+public:
+    explicit PublishPipeline(const PublishPipelineConfig& config);
+    ~PublishPipeline();
+
+    const PublishPipelineConfig& getConfig() const { return config; }
+    std::size_t threadCount() const { return pool->size(); }
+
+    /**
+     * @brief Route a publication's objects through the pipeline.
+     */
+    void attach(const std::shared_ptr<PublicationDelegate>& delegate);
+
+private:
+    const PublishPipelineConfig config;
+    std::shared_ptr<WorkStealingPool> pool;
+};
+
+}        // namespace qmedia
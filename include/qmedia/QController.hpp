@@ -2,6 +2,10 @@
 
 #include "QuicrDelegates.hpp"
 #include "ManifestTypes.hpp"
+#include "BufferPool.hpp"
+#include "DeliveryExecutor.hpp"
+#include "LayerAdaptation.hpp"
+#include "PublishPipeline.hpp"
 
 #include <nlohmann/json.hpp>
 #include <quicr/quicr_common.h>
@@ -9,9 +13,14 @@
 #include <spdlog/spdlog.h>
 #include <transport/transport.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
 #include <thread>
 #include <optional>
+#include <span>
 #include <sframe/sframe.h>
 
 using json = nlohmann::json;
@@ -21,6 +30,10 @@ namespace qmedia
 {
 
 constexpr sframe::CipherSuite Default_Cipher_Suite = sframe::CipherSuite::AES_GCM_128_SHA256;
+constexpr std::chrono::milliseconds Default_Epoch_Overlap{2000};
+
+// Epoch of the built-in key, until epochs are installed.
+constexpr std::uint64_t Fixed_Epoch = 1;
 
 class QController
 {
@@ -35,7 +48,8 @@ public:
                 std::shared_ptr<QPublisherDelegate> publisherDelegate,
                 std::shared_ptr<spdlog::logger> logger,
                 const bool debugging = false,
-                const std::optional<sframe::CipherSuite> cipherSuite = Default_Cipher_Suite);
+                const std::optional<sframe::CipherSuite> cipherSuite = Default_Cipher_Suite,
+                const BufferPoolConfig& bufferPoolConfig = {});
 
     ~QController();
 
@@ -56,14 +70,193 @@ public:
 
     void updateManifest(const manifest::Manifest& manifest_obj);
 
-    // FIXME(richbarn): These methods should use std::range<const uint8_t>
-    // instead of naked pointers and lengths.
     void publishNamedObject(const quicr::Namespace& quicrNamespace,
                             const std::uint8_t* data,
                             std::size_t len,
                             bool groupFlag);
+
+    /**
+     * @brief Publish an object the caller does not own. The data is read in
+     *        place; it is copied at most once into the buffer handed to the
+     *        transport.
+     */
+    void publishNamedObject(const quicr::Namespace& quicrNamespace,
+                            std::span<const std::uint8_t> data,
+                            bool groupFlag);
+
+    /**
+     * @brief Publish an object whose buffer ownership is transferred to the
+     *        controller. Unencrypted objects are handed to the transport
+     *        without any copy.
+     */
+    void publishNamedObject(const quicr::Namespace& quicrNamespace, quicr::bytes&& data, bool groupFlag);
+
+    /**
+     * @brief Publish a buffer obtained from allocateObjectBuffer. Encryption
+     *        happens in place, so the buffer's storage is sent as-is.
+     */
+    void publishNamedObject(const quicr::Namespace& quicrNamespace, ObjectBuffer&& data, bool groupFlag);
+
+    /**
+     * @brief Allocate a buffer for size bytes of payload with the headroom
+     *        the publication needs to encrypt it in place.
+     */
+    ObjectBuffer allocateObjectBuffer(const quicr::Namespace& quicrNamespace, std::size_t size);
+
+    /**
+     * @brief Get a handle for publishing to a namespace without a lookup per
+     *        object. Call after updateManifest; the handle is invalid if the
+     *        namespace is not published.
+     */
+    PublicationHandle getPublicationHandle(const quicr::Namespace& quicrNamespace);
+
+    void publishNamedObject(const PublicationHandle& handle, std::span<const std::uint8_t> data, bool groupFlag);
+    void publishNamedObject(const PublicationHandle& handle, quicr::bytes&& data, bool groupFlag);
+    void publishNamedObject(const PublicationHandle& handle, ObjectBuffer&& data, bool groupFlag);
+    ObjectBuffer allocateObjectBuffer(const PublicationHandle& handle, std::size_t size);
+
+    /**
+     * @brief Publish several objects at once, e.g. the NAL units of an access
+     *        unit or every simulcast layer of a frame. Consecutive objects for
+     *        the same publication share one lock acquisition and trace start.
+     *        Objects are published in order; buffers are consumed.
+     */
+    void publishNamedObjects(std::span<PublishObject> objects);
     void publishNamedObjectTest(std::uint8_t* data, std::size_t len, bool groupFlag);
 
+    /**
+     * @brief Encrypt and send published objects on a work-stealing thread
+     *        pool instead of the publishing thread. Objects are queued per
+     *        publication and keep their order, while different publications
+     *        (e.g. simulcast layers) are encrypted in parallel. Call before
+     *        updateManifest; existing publications are not moved to the
+     *        pipeline.
+     */
+    void setPublishPipeline(const PublishPipelineConfig& config);
+
+    /**
+     * @brief Pace video publications with a token bucket at the bitrate
+     *        (br=) of their qualityProfile, so keyframe bursts are spread out
+     *        instead of hitting the transport at line rate. Audio bypasses
+     *        the pacer unless configured otherwise. Call before
+     *        updateManifest.
+     */
+    void setPacing(const PacerConfig& config);
+
+    /**
+     * @brief Override the paced bitrate (kbps) of a publication; 0 stops
+     *        pacing it.
+     * @returns False if the publication is not found or not paced.
+     */
+    bool setPublicationBitrate(const quicr::Namespace& quicrNamespace, std::uint32_t bitrate);
+
+    /**
+     * @brief Deliver objects of unordered subscriptions (any transport mode
+     *        but ReliablePerTrack) in (group, object) order. Early objects
+     *        are held for up to the configured latency waiting for the ones
+     *        before them. Call before updateManifest.
+     */
+    void setReorderBuffer(const ReorderBufferConfig& config);
+
+    /**
+     * @brief Deliver received objects to subscription delegates on a small
+     *        pool of threads instead of the transport thread, so a slow
+     *        decoder does not hold up the other subscriptions. Objects are
+     *        queued per subscription and keep their order. Call before
+     *        updateManifest.
+     */
+    void setDeliveryExecutor(const DeliveryExecutorConfig& config);
+
+    /**
+     * @brief Receive counters and histograms of a subscription, including
+     *        its fragment, reorder and delivery stats. Reading them does not
+     *        slow down the receive path.
+     */
+    SubscriptionStats getSubscriptionStats(const quicr::Namespace& quicrNamespace);
+
+    /**
+     * @brief Subscription stats summed over every subscription of a source,
+     *        e.g. all of its simulcast layers.
+     */
+    SubscriptionStats getSourceStats(const SourceId& sourceId);
+
+    /**
+     * @brief Drop received objects once they are older than the given
+     *        latency, instead of the expiry the manifest declares for the
+     *        subscription. Zero delivers every object however late.
+     * @returns False if the subscription is not found.
+     */
+    bool setSubscriptionMaxLatency(const quicr::Namespace& quicrNamespace, std::chrono::milliseconds latency);
+
+    /**
+     * @brief Receive a single layer of each singleordered subscription that
+     *        offers several profiles, and move between layers as the loss
+     *        and throughput of the received one change. A switch subscribes
+     *        to the new layer first and hands over at the start of its next
+     *        group before unsubscribing the old one. Call before
+     *        updateManifest.
+     */
+    void setLayerAdaptation(const LayerAdaptationConfig& config);
+
+    /**
+     * @brief Highest layer an adaptive source may be received at, 0 being
+     *        the lowest bitrate, e.g. to match the size it is rendered at.
+     * @returns False if the source is not adaptive.
+     */
+    bool setMaxLayer(const SourceId& sourceId, std::size_t layer);
+
+    /**
+     * @brief Layer an adaptive source is received at, 0 being the lowest
+     *        bitrate.
+     */
+    std::optional<std::size_t> getLayer(const SourceId& sourceId);
+
+    /**
+     * @brief Install the secret of a new SFrame epoch, e.g. after a rekey.
+     *        The keys of every namespace in use are derived for the epoch in
+     *        the background, after which publications encrypt with it. The
+     *        epoch it replaces keeps decrypting for the overlap window from
+     *        that switch, so objects in flight still play, then its keys are
+     *        evicted.
+     */
+    void installEpoch(std::uint64_t epoch, const quicr::bytes& secret);
+
+    /**
+     * @brief How long a replaced epoch keeps decrypting, Default_Epoch_Overlap
+     *        unless set. Applies to epochs replaced from now on.
+     */
+    void setEpochOverlap(std::chrono::milliseconds overlap);
+
+    /**
+     * @brief Objects, sent or received, that found their key missing and
+     *        derived it first instead of it being prepared ahead.
+     */
+    std::uint64_t getColdKeyMisses() const { return sframe_context ? sframe_context->getColdKeyMisses() : 0; }
+
+    /**
+     * @brief SFrame keys held, one per namespace in use and live epoch.
+     */
+    std::size_t getKeyCount() const { return sframe_context ? sframe_context->getKeyCount() : 0; }
+
+    /**
+     * @brief Blocks until the keys of the delegates and epochs created so
+     *        far are derived.
+     */
+    void awaitKeyWarmups();
+
+    /**
+     * @brief Publish queue depth, drop counters and pacing delay of a
+     *        publication.
+     */
+    PublicationStats getPublicationStats(const quicr::Namespace& quicrNamespace);
+
+    /**
+     * @brief Record method traces for published objects. Off by default
+     *        unless the controller was created with debugging enabled.
+     */
+    void setTracing(bool enabled) { tracing = enabled; }
+    bool isTracing() const { return tracing; }
+
     void setSubscriptionSingleOrdered(bool new_value) { is_singleordered_subscription = new_value; }
     void setPublicationSingleOrdered(bool new_value) { is_singleordered_publication = new_value; }
 
@@ -75,13 +268,14 @@ public:
     void setPublicationState(const quicr::Namespace& quicrNamespace, const PublicationState);
     void setSubscriptionState(const quicr::Namespace& quicrNamespace, const quicr::TransportMode);
     quicr::SubscriptionState getSubscriptionState(const quicr::Namespace& quicrNamespace);
-private:
-    struct PublicationDetails
-    {
-        PublicationState state;
-        std::shared_ptr<PublicationDelegate> delegate;
-    };
 
+    /**
+     * @brief Return a buffer, such as a delivered object, to the controller's
+     *        buffer pool once the application is done with it.
+     */
+    void recycleBuffer(quicr::bytes&& buffer) { buffer_pool->release(std::move(buffer)); }
+    BufferPool::Stats getBufferPoolStats() const { return buffer_pool->stats(); }
+private:
     /**
      * @brief Unsubscribe from all subscriptions.
      */
@@ -103,7 +297,7 @@ private:
                                     const std::string& authToken,
                                     quicr::bytes&& e2eToken,
                                     std::shared_ptr<qmedia::QSubscriptionDelegate> delegate,
-                                    const std::optional<sframe::CipherSuite> cipherSuite);
+                                    bool fragmented);
 
     std::shared_ptr<PublicationDelegate> findQuicrPublicationDelegate(const quicr::Namespace& quicrNamespace);
 
@@ -115,7 +309,8 @@ private:
                                                                         quicr::bytes&& payload,
                                                                         const std::vector<std::uint8_t>& priority,
                                                                         const std::vector<std::uint16_t>& expiry,
-                                                                        const quicr::TransportMode transportMode);
+                                                                        const quicr::TransportMode transportMode,
+                                                                        std::size_t fragmentSize);
 
     std::shared_ptr<QSubscriptionDelegate> getSubscriptionDelegate(const SourceId& sourceId,
                                                                    const manifest::ProfileSet& profileSet);
@@ -131,7 +326,8 @@ private:
                           const std::string& originUrl,
                           const quicr::TransportMode transportMode,
                           const std::string& authToken,
-                          quicr::bytes& e2eToken);
+                          quicr::bytes& e2eToken,
+                          bool fragmented);
 
     int startPublication(std::shared_ptr<qmedia::QPublicationDelegate> qDelegate,
                          const std::string sourceId,
@@ -141,10 +337,55 @@ private:
                          quicr::bytes&& payload,
                          const std::vector<std::uint8_t>& priority,
                          const std::vector<std::uint16_t>& expiry,
-                         const quicr::TransportMode transportMode);
+                         const quicr::TransportMode transportMode,
+                         std::size_t fragmentSize);
 
     void stopPublication(const quicr::Namespace& quicrNamespace);
 
+    /**
+     * @brief Runs a delegate's key derivation in the background, so it is
+     *        done by the time its first object arrives or is published.
+     *        Warm-ups run one at a time, in order, on a single thread.
+     */
+    void warmKeys(std::function<void()> prepare);
+    void runKeyWarmups();
+
+    /**
+     * @brief Derives an installed epoch's keys and, unless a later epoch was
+     *        installed meanwhile, switches publications to it. Runs as a
+     *        warm-up.
+     */
+    void enableInstalledEpoch(std::uint64_t epoch);
+    void runEpochRetirement();
+
+    TraceBuffer startTrace() const { return TraceBuffer("qController:publishNamedObject", tracing); }
+
+    void runReorderFlush(std::chrono::milliseconds interval);
+    void runLayerAdaptation(std::chrono::milliseconds interval);
+
+    struct LayerSet
+    {
+        std::shared_ptr<QSubscriptionDelegate> qDelegate;
+        quicr::TransportMode transportMode;
+        std::vector<manifest::Profile> layers;        // Lowest bitrate first
+        LayerAdaptation adaptation;
+        std::optional<std::size_t> pending;           // Layer being switched to
+        std::chrono::steady_clock::time_point pending_since;
+        SubscriptionStats last;                       // Current layer at the previous sample
+    };
+
+    void startAdaptiveSubscription(std::shared_ptr<QSubscriptionDelegate> qDelegate,
+                                   const SourceId& sourceId,
+                                   const manifest::ProfileSet& profileSet,
+                                   const quicr::TransportMode transportMode);
+
+    // NOTE: caller must lock layersMutex
+    void adaptLayers(const SourceId& sourceId, LayerSet& set, std::chrono::steady_clock::time_point now);
+    void startLayerSwitch(const SourceId& sourceId,
+                          LayerSet& set,
+                          std::size_t layer,
+                          std::chrono::steady_clock::time_point now);
+
     void processURLTemplates(const std::vector<std::string>& urlTemplates);
     void processSubscriptions(const std::vector<manifest::MediaStream>& subscriptions);
     void processPublications(const std::vector<manifest::MediaStream>& publications);
@@ -164,15 +405,63 @@ private:
     std::map<SourceId, std::shared_ptr<QPublicationDelegate>> qPublicationsMap;
 
     quicr::namespace_map<std::shared_ptr<SubscriptionDelegate>> quicrSubscriptionsMap;
-    quicr::namespace_map<PublicationDetails> quicrPublicationsMap;
+    quicr::namespace_map<std::shared_ptr<PublicationDelegate>> quicrPublicationsMap;
 
     std::shared_ptr<quicr::Client> client_session;
+    std::shared_ptr<BufferPool> buffer_pool;
+    std::unique_ptr<PublishPipeline> publish_pipeline;
+    std::unique_ptr<DeliveryExecutor> delivery_executor;
+    std::shared_ptr<PacedSender> paced_sender;
+    PacerConfig pacer_config;
+
+    std::atomic<bool> tracing;
+
+    // Releases objects held by reorder buffers once their wait expires.
+    std::optional<ReorderBufferConfig> reorder_config;
+    std::thread reorder_thread;
+
+    // Samples the received layer of adaptive sources and switches layers.
+    std::optional<LayerAdaptationConfig> adaptation_config;
+    std::mutex layersMutex;
+    std::map<SourceId, LayerSet> layerSets;
+    std::thread adaptation_thread;
+
+    // Key derivations of new delegates and epochs, waiting for the warm-up
+    // thread. One thread keeps a large manifest from starting one per stream.
+    std::mutex warmupsMutex;
+    std::condition_variable warmups_cv;
+    std::deque<std::function<void()>> key_warmups;
+    bool warmups_stop = false;
+    bool warmup_running = false;
+    std::thread warmup_thread;
+
+    // SFrame keys shared by every delegate, null when not encrypting.
+    std::shared_ptr<QSFrameContext> sframe_context;
+
+    // Epoch installed last with installEpoch, and the one publications
+    // encrypt with: the built-in Fixed_Epoch until an installed epoch's keys
+    // are derived. Secrets wait in pending_epochs for the warm-up thread.
+    // Replaced epochs are evicted once their overlap ends, the enabled one
+    // never is. epochUpdateMutex serializes adding and evicting keys, so a
+    // slow install can't bring back a retired epoch.
+    std::mutex epochsMutex;
+    std::mutex epochUpdateMutex;
+    std::optional<std::uint64_t> current_epoch;
+    std::uint64_t enabled_epoch = Fixed_Epoch;
+    std::map<std::uint64_t, quicr::bytes> pending_epochs;
+    std::map<std::uint64_t, std::chrono::steady_clock::time_point> retiring_epochs;
+    std::chrono::milliseconds epoch_overlap = Default_Epoch_Overlap;
+    std::thread epoch_thread;
+
+    // Wakes the periodic threads above when stopping.
+    std::mutex periodic_mutex;
+    std::condition_variable periodic_cv;
+    bool periodic_stop = false;
 
     bool stop;
     bool closed;
     bool is_singleordered_subscription = true;
     bool is_singleordered_publication = false;
-    std::optional<sframe::CipherSuite> cipher_suite;
 };
 
 }        // namespace qmedia
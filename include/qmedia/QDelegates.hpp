@@ -5,11 +5,26 @@
 #include <quicr/namespace.h>
 #include <quicr/quicr_common.h>
 #include <quicr/quicr_client.h>
+#include <chrono>
+#include <span>
 #include <string>
 #include <iostream>
 
 namespace qmedia
 {
+/**
+ * @brief A received object in a batch handed to subscribedObjects. The
+ *        consumer may move the data out.
+ */
+struct ObjectView
+{
+    quicr::bytes data;
+    std::uint32_t groupId = 0;
+    std::uint16_t objectId = 0;
+    std::uint8_t priority = 0;
+    std::chrono::steady_clock::time_point received;        // When the object arrived, before decryption
+};
+
 class QSubscriptionDelegate
 {
 public:
@@ -22,6 +37,31 @@ public:
                         quicr::TransportMode& transportMode) = 0;
     virtual int update(const std::string& sourceId, const std::string& label, const manifest::ProfileSet& profiles) = 0;
     virtual int subscribedObject(const quicr::Namespace& quicrNamespace, quicr::bytes&& data, std::uint32_t groupId, std::uint16_t objectId) = 0;
+
+    /**
+     * @brief Receive every object available for the subscription at once, in
+     *        order, e.g. a burst drained by the delivery executor. Override to
+     *        process bursts together; the default hands each object to
+     *        subscribedObject.
+     */
+    virtual int subscribedObjects(const quicr::Namespace& quicrNamespace, std::span<ObjectView> objects)
+    {
+        int result = 0;
+        for (auto& object : objects)
+        {
+            const auto error = subscribedObject(quicrNamespace, std::move(object.data), object.groupId, object.objectId);
+            if (error != 0) result = error;
+        }
+        return result;
+    }
+
+    /**
+     * @brief A group is missing objects that did not arrive within the
+     *        reorder window, e.g. to request a keyframe instead of decoding
+     *        a broken group. Called on the receive thread, possibly ahead of
+     *        objects of the group still queued for delivery.
+     */
+    virtual void groupIncomplete(const quicr::Namespace& /* quicrNamespace */, std::uint32_t /* groupId */) {}
 };
 
 class QPublicationDelegate
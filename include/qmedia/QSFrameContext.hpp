@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <map>
 #include <vector>
@@ -11,36 +15,222 @@
 namespace qmedia
 {
 
+/**
+ * @brief SFrame keys per namespace and epoch, shared by the threads that
+ *        protect and unprotect objects.
+ *
+ * Readers work on an immutable snapshot of the keys, published through an
+ * atomic pointer, and never take a lock: entering and leaving a read is one
+ * atomic increment and decrement. Writers (adding or enabling an epoch,
+ * installing the key of a new namespace) copy the snapshot, publish the copy
+ * and free the old one once the readers that might still see it are done.
+ *
+ * Keys are derived on first use unless prepared ahead with prepareKeys;
+ * adding an epoch derives it for every namespace already in use. Removing an
+ * epoch drops its secret and keys, so only live epochs take memory; likewise
+ * a namespace's keys go once its last user releases it.
+ */
 class QSFrameContext
 {
 public:
+    // Largest authentication tag appended by any supported cipher suite.
+    static constexpr std::size_t Max_Tag_Size = 16;
+
     QSFrameContext(sframe::CipherSuite cipher_suite);
     QSFrameContext(QSFrameContext& other);
+    ~QSFrameContext();
+
+    QSFrameContext& operator=(const QSFrameContext&) = delete;
 
+    /**
+     * @brief Adds the secret of an epoch, replacing the keys derived from a
+     *        previous secret of the same epoch.
+     */
     void addEpoch(uint64_t epoch_id, const quicr::bytes& epoch_secret);
     void enableEpoch(uint64_t epoch_id);
 
+    /**
+     * @brief Forgets an epoch's secret and keys, its objects no longer
+     *        decrypt. Removing the current epoch stops protect until another
+     *        is enabled.
+     */
+    void removeEpoch(uint64_t epoch_id);
+
+    /**
+     * @brief The epoch protect encrypts with, if any is enabled.
+     */
+    std::optional<uint64_t> currentEpoch() const;
+
+    /**
+     * @brief Keys derived and held, one per namespace and epoch.
+     */
+    std::size_t getKeyCount() const;
+
+    /**
+     * @brief Derive the keys of every known epoch for a namespace ahead of
+     *        its first object, so that object does not wait for them.
+     */
+    void prepareKeys(const quicr::Namespace& quicr_namespace);
+
+    /**
+     * @brief Count a user of a namespace, e.g. a publication or subscription.
+     *        When the last user releases it, the namespace's keys are dropped,
+     *        so they neither stay behind nor get derived for later epochs.
+     */
+    void retainNamespace(const quicr::Namespace& quicr_namespace);
+    void releaseNamespace(const quicr::Namespace& quicr_namespace);
+
+    /**
+     * @brief Objects that found their key missing and derived it first.
+     */
+    std::uint64_t getColdKeyMisses() const { return cold_key_misses.load(std::memory_order_relaxed); }
+
     sframe::output_bytes protect(const quicr::Namespace& quicr_namespace,
                                  sframe::Counter ctr,
                                  sframe::output_bytes ciphertext,
                                  const sframe::input_bytes plaintext);
 
+    /**
+     * @brief Encrypts the first plaintext_size bytes of buffer in place. The
+     *        buffer must leave Max_Tag_Size bytes of room after the plaintext.
+     */
+    sframe::output_bytes protect(const quicr::Namespace& quicr_namespace,
+                                 sframe::Counter ctr,
+                                 sframe::output_bytes buffer,
+                                 std::size_t plaintext_size);
+
+    /**
+     * @brief Encrypt with the given epoch rather than the current one, e.g.
+     *        the epoch already written in front of the object.
+     */
+    sframe::output_bytes protect(uint64_t epoch,
+                                 const quicr::Namespace& quicr_namespace,
+                                 sframe::Counter ctr,
+                                 sframe::output_bytes ciphertext,
+                                 const sframe::input_bytes plaintext);
+    sframe::output_bytes protect(uint64_t epoch,
+                                 const quicr::Namespace& quicr_namespace,
+                                 sframe::Counter ctr,
+                                 sframe::output_bytes buffer,
+                                 std::size_t plaintext_size);
+
     sframe::output_bytes unprotect(uint64_t epoch,
                                    const quicr::Namespace& quicr_namespace,
                                    sframe::Counter ctr,
                                    sframe::output_bytes plaintext,
                                    const sframe::input_bytes ciphertext);
 
+    /**
+     * @brief Decrypts buffer (ciphertext and tag) in place. The plaintext is
+     *        returned as a view of the front of buffer.
+     */
+    sframe::output_bytes unprotect(uint64_t epoch,
+                                   const quicr::Namespace& quicr_namespace,
+                                   sframe::Counter ctr,
+                                   sframe::output_bytes buffer);
+
 protected:
-    void ensure_key(uint64_t epoch_id, const quicr::Namespace& quicr_namespace);
-    sframe::bytes derive_base_key(uint64_t epoch_id, const quicr::Namespace& quicr_namespace);
+    struct ContextKey
+    {
+        quicr::Namespace quicr_namespace;
+        uint64_t epoch_id = 0;
+
+        friend bool operator==(const ContextKey& lhs, const ContextKey& rhs) = default;
+    };
+
+    // An empty slot has no context.
+    struct ContextSlot
+    {
+        ContextKey key;
+        std::shared_ptr<sframe::ContextBase> context;
+    };
+
+    /**
+     * @brief Everything readers need, never modified once published.
+     *
+     * Each (namespace, epoch) key has its own sframe context. They sit in an
+     * open addressing index with linear probing, a power of two in size and
+     * at most half full, so a lookup is usually a single probe. Snapshots
+     * share the contexts.
+     */
+    struct KeySet
+    {
+        std::optional<uint64_t> current_epoch;
+        std::map<uint64_t, quicr::bytes> epoch_secrets;
+        std::vector<ContextSlot> contexts;
+        std::size_t context_count = 0;
+
+        sframe::ContextBase* find(const ContextKey& key) const;
+        void insert(const ContextKey& key, std::shared_ptr<sframe::ContextBase> context);
+        void erase_epoch(uint64_t epoch_id);
+        void erase_namespace(const quicr::Namespace& quicr_namespace);
+
+        template<typename Predicate>
+        void erase_if(Predicate erased);
+    };
+
+    /**
+     * @brief Keeps the snapshot it loaded alive until destroyed.
+     */
+    class ReadSection
+    {
+    public:
+        ReadSection(const QSFrameContext& context);
+        ~ReadSection();
+
+        const KeySet& keys() const { return *key_set; }
+
+    private:
+        const QSFrameContext& context;
+        std::size_t phase;
+        std::size_t stripe;
+        const KeySet* key_set;
+    };
+
+    /**
+     * @brief Derives and installs the keys not installed yet, skipping epochs
+     *        without a secret. Derivation runs outside the lock, keys whose
+     *        epoch was removed or replaced meanwhile are discarded, as are
+     *        keys of namespaces released meanwhile if in_use_only.
+     * @note Must not be called within a ReadSection, it waits for readers.
+     */
+    void install_keys(const std::vector<ContextKey>& keys, bool in_use_only = false);
+    void install_key(uint64_t epoch_id, const quicr::Namespace& quicr_namespace);
+
+    // NOTE: caller must lock update_mutex
+    std::unique_ptr<KeySet> copy_keys() const;
+    void publish(std::unique_ptr<KeySet> next);
+
+    static std::uint64_t hash(const ContextKey& key);
+    sframe::bytes derive_base_key(const quicr::bytes& epoch_secret, const quicr::Namespace& quicr_namespace) const;
 
     sframe::CipherSuite cipher_suite;
-    std::optional<uint64_t> current_epoch;
-    std::map<uint64_t, quicr::bytes> epoch_secrets;
-    std::map<quicr::Namespace, sframe::ContextBase> ns_contexts;        // key_id=epoch
 
-    std::mutex context_mutex;
+    std::atomic<const KeySet*> key_set;
+
+    static constexpr std::size_t Cache_Line_Size = 64;
+    static constexpr std::size_t Reader_Stripes = 8;
+
+    // Each count has a cache line of its own, so threads on different
+    // stripes don't bounce it between cores.
+    struct alignas(Cache_Line_Size) ReaderCount
+    {
+        std::atomic<std::uint64_t> count = 0;
+    };
+
+    // Readers count themselves in the current phase, on their thread's
+    // stripe; a writer flips the phase and waits for every stripe of the
+    // previous one to drain before freeing. The phase is only written by
+    // writers, so it shares its line with nothing that readers modify.
+    alignas(Cache_Line_Size) std::atomic<std::size_t> reader_phase = 0;
+    mutable std::array<std::array<ReaderCount, Reader_Stripes>, 2> readers = {};
+
+    std::mutex update_mutex;
+
+    // NOTE: caller must lock update_mutex
+    std::map<quicr::Namespace, std::size_t> namespace_users;
+
+    std::atomic<std::uint64_t> cold_key_misses = 0;
 };
 
 }        // namespace qmedia
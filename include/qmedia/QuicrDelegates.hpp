@@ -1,7 +1,21 @@
 #pragma once
 
 #include "QSFrameContext.hpp"
+#include "qmedia/BufferPool.hpp"
+#include "qmedia/DeliveryExecutor.hpp"
+#include "qmedia/DuplicateFilter.hpp"
+#include "qmedia/FragmentAssembler.hpp"
+#include "qmedia/GroupClock.hpp"
+#include "qmedia/Histogram.hpp"
+#include "qmedia/LossTracker.hpp"
+#include "qmedia/MPMCQueue.hpp"
+#include "qmedia/ObjectBuffer.hpp"
+#include "qmedia/Pacer.hpp"
+#include "qmedia/PublishPipeline.hpp"
 #include "qmedia/QDelegates.hpp"
+#include "qmedia/ReorderBuffer.hpp"
+#include "qmedia/SPSCQueue.hpp"
+#include "qmedia/TraceBuffer.hpp"
 
 #include <transport/transport.h>
 
@@ -9,12 +23,42 @@
 #include <quicr/quicr_common.h>
 #include <quicr/quicr_client.h>
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 
 namespace qmedia
 {
 
+class QController;
+struct PublishObject;
+
+struct SubscriptionStats
+{
+    std::uint64_t objects = 0;
+    std::uint64_t bytes = 0;              // As received, before decryption
+    std::uint64_t decrypt_failures = 0;
+    std::uint64_t expired = 0;            // Dropped before decryption, past the deadline
+    std::uint64_t duplicates = 0;         // Dropped before decryption, already received
+
+    HistogramSnapshot inter_arrival;        // Microseconds between objects
+    HistogramSnapshot object_size;          // Bytes as received
+
+    LossStats loss = {};
+    FragmentAssemblerStats fragments = {};
+    ReorderBufferStats reorder = {};
+    DeliveryStats delivery = {};
+
+    /**
+     * @brief Aggregate another subscription, e.g. every layer of a source.
+     */
+    SubscriptionStats& operator+=(const SubscriptionStats& other);
+};
+
 class SubscriptionDelegate : public quicr::SubscriberDelegate, public std::enable_shared_from_this<SubscriptionDelegate>
 {
     SubscriptionDelegate(const std::string& sourceId,
@@ -26,7 +70,8 @@ class SubscriptionDelegate : public quicr::SubscriberDelegate, public std::enabl
                          quicr::bytes e2eToken,
                          std::shared_ptr<qmedia::QSubscriptionDelegate> qDelegate,
                          std::shared_ptr<spdlog::logger> logger,
-                         const std::optional<sframe::CipherSuite> cipherSuite);
+                         std::shared_ptr<QSFrameContext> sframeContext,
+                         std::shared_ptr<BufferPool> bufferPool);
 
 public:
     [[nodiscard]] static std::shared_ptr<SubscriptionDelegate>
@@ -39,7 +84,10 @@ public:
            quicr::bytes e2eToken,
            std::shared_ptr<qmedia::QSubscriptionDelegate> qDelegate,
            std::shared_ptr<spdlog::logger> logger,
-           const std::optional<sframe::CipherSuite> cipherSuite);
+           std::shared_ptr<QSFrameContext> sframeContext,
+           std::shared_ptr<BufferPool> bufferPool);
+
+    ~SubscriptionDelegate();
 
     std::shared_ptr<SubscriptionDelegate> getptr() { return shared_from_this(); }
 
@@ -47,6 +95,65 @@ public:
 
     std::string getSourceId() const { return sourceId; }
 
+    /**
+     * @brief Expect objects published with fragmentation enabled and deliver
+     *        them reassembled. Call before subscribing.
+     */
+    void enableFragmentation(const FragmentAssemblerConfig& config = {});
+
+    /**
+     * @brief Deliver objects in (group, object) order, holding early ones for
+     *        up to the configured latency. Call before subscribing.
+     */
+    void enableReorderBuffer(const ReorderBufferConfig& config);
+
+    /**
+     * @brief Deliver held objects whose wait has expired. Called periodically
+     *        while the reorder buffer is enabled.
+     */
+    void flushReorderBuffer();
+
+    /**
+     * @brief Drop objects before decryption once a later group has been
+     *        arriving for longer than the deadline, i.e. the object is at
+     *        least that old. Zero disables.
+     */
+    void setDeadline(std::chrono::milliseconds deadline) { deadlineMs = deadline.count(); }
+
+    /**
+     * @brief Take over from another layer of the same source. Nothing is
+     *        delivered until the first object of a group arrives, at which
+     *        point the replaced layer stops delivering, so the decoder
+     *        switches at a group boundary. Call before subscribing.
+     */
+    void replaceLayer(std::weak_ptr<SubscriptionDelegate> replaced);
+
+    /**
+     * @brief Whether received objects reach the application. False for a
+     *        replacement layer still waiting for a group to start, and for
+     *        the layer it replaced.
+     */
+    bool isDelivering() const { return delivering.load(std::memory_order_acquire); }
+    void stopDelivering() { delivering.store(false, std::memory_order_release); }
+
+    /**
+     * @brief Hand objects to the application on the executor's threads
+     *        instead of the transport thread. Call before subscribing.
+     */
+    void enableDeliveryExecutor(std::weak_ptr<WorkStealingPool> pool, const DeliveryExecutorConfig& config);
+
+    /**
+     * @brief Derive the decryption keys of the namespace ahead of the first
+     *        object. Slow, call off the media path.
+     */
+    void prepareKeys();
+
+    /**
+     * @brief Snapshot of the receive counters. Safe to call from any thread,
+     *        it does not contend with the receive path.
+     */
+    SubscriptionStats getStats() const;
+
     /*===========================================================================*/
     // Events
     /*===========================================================================*/
@@ -60,8 +167,11 @@ public:
                                     uint8_t priority,
                                     quicr::bytes&& data);
 
-    virtual void
-    onSubscribedObjectFragment(const quicr::Name&, uint8_t, const uint64_t&, bool, quicr::bytes&&);
+    virtual void onSubscribedObjectFragment(const quicr::Name& quicrName,
+                                            uint8_t priority,
+                                            const uint64_t& offset,
+                                            bool is_last_fragment,
+                                            quicr::bytes&& data);
 
     /*===========================================================================*/
     // Actions
@@ -70,6 +180,36 @@ public:
     void subscribe(std::shared_ptr<quicr::Client> quicrClient, const quicr::TransportMode transport_mode);
     void unsubscribe(std::shared_ptr<quicr::Client> quicrClient);
 
+private:
+    struct QueuedObject
+    {
+        ObjectView object;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    /**
+     * @brief Hands an object to the application, through the delivery queue
+     *        when there is one.
+     */
+    void deliver(ObjectView&& object);
+    void deliverReleased();
+
+    /**
+     * @brief Hands a batch of objects to the application in one call.
+     */
+    void forward(std::span<ObjectView> objects);
+
+    /**
+     * @brief Whether an object of the group arrived later than the deadline
+     *        after its group was due to end.
+     */
+    bool isExpired(std::uint32_t groupId, std::chrono::steady_clock::time_point now);
+
+    void notifyIncompleteGroups();
+
+    void scheduleDelivery();
+    void drainDeliveryQueue();
+
 private:
     bool canReceiveSubs;
     std::string sourceId;
@@ -81,15 +221,64 @@ private:
     std::shared_ptr<qmedia::QSubscriptionDelegate> qDelegate;
     const std::shared_ptr<spdlog::logger> logger;
 
-    std::uint64_t groupCount;
-    std::uint64_t objectCount;
-    std::uint64_t groupGapCount;
-    std::uint64_t objectGapCount;
-
-    std::uint32_t currentGroupId;
-    std::uint16_t currentObjectId;
+    // Position in the stream, only touched by the receive thread.
+    LossTracker lossTracker;
+    std::vector<std::uint32_t> incompleteGroups;
+    std::chrono::steady_clock::time_point lastArrival;
+    GroupClock groupClock;
+    DuplicateFilter duplicateFilter;
+    std::atomic<std::int64_t> deadlineMs = 0;
+
+    // Layer switching, see replaceLayer.
+    std::atomic<bool> delivering = true;
+    bool awaitingGroup = false;
+    std::weak_ptr<SubscriptionDelegate> replacedLayer;
+
+    // Relaxed counters, read by getStats from any thread.
+    std::atomic<std::uint64_t> objectCount = 0;
+    std::atomic<std::uint64_t> receivedBytes = 0;
+    std::atomic<std::uint64_t> decryptFailures = 0;
+    std::atomic<std::uint64_t> expiredCount = 0;
+    std::atomic<std::uint64_t> duplicateCount = 0;
+    Histogram interArrival;        // Microseconds
+    Histogram objectSize;          // Bytes as received
+
+    // Shared by every delegate of the controller, null when not encrypting.
+    std::shared_ptr<QSFrameContext> sframe_context;
+    std::shared_ptr<BufferPool> buffer_pool;
+    FragmentAssembler transport_assembler;
+    std::optional<FragmentAssembler> fragment_assembler;
+
+    std::mutex reorder_mutex;
+    std::optional<ReorderBuffer> reorder_buffer;
+    std::vector<ReorderBuffer::Object> reorder_released;
+    std::vector<ObjectView> released_batch;        // Guarded by reorder_mutex
+
+    std::unique_ptr<MPMCQueue<QueuedObject>> delivery_queue;
+    std::vector<ObjectView> drain_batch;        // Only used by the one running drain
+    std::weak_ptr<WorkStealingPool> delivery_pool;
+    DeliveryOverflowPolicy overflow_policy = DeliveryOverflowPolicy::drop_oldest;
+    std::atomic<bool> delivery_scheduled = false;
+    std::atomic<std::uint64_t> delivered_count = 0;
+    std::atomic<std::uint64_t> delivery_dropped = 0;
+    std::atomic<std::uint64_t> delivery_latency_total_us = 0;
+    std::atomic<std::uint64_t> delivery_latency_max_us = 0;
+};
 
-    std::optional<QSFrameContext> sframe_context;
+/**
+ * @brief Publish pipeline counters for a publication.
+ */
+struct PublicationStats
+{
+    std::size_t queue_depth = 0;        // Objects waiting for the pipeline
+    std::uint64_t queued = 0;
+    std::uint64_t dropped = 0;          // Objects dropped because the queue was full
+    std::uint64_t sent = 0;             // Objects handed to the transport
+
+    std::size_t pacing_queue = 0;       // Objects waiting in the pacer
+    std::uint64_t paced = 0;            // Objects the pacer held back
+    std::chrono::microseconds pacing_delay_total{};
+    std::chrono::microseconds pacing_delay_max{};
 };
 
 class PublicationDelegate : public quicr::PublisherDelegate, public std::enable_shared_from_this<PublicationDelegate>
@@ -104,7 +293,8 @@ class PublicationDelegate : public quicr::PublisherDelegate, public std::enable_
                         const std::vector<std::uint8_t>& priority,
                         const std::vector<std::uint16_t>& expiry,
                         std::shared_ptr<spdlog::logger> logger,
-                        const std::optional<sframe::CipherSuite> cipherSuite);
+                        std::shared_ptr<QSFrameContext> sframeContext,
+                        std::shared_ptr<BufferPool> bufferPool);
 
 public:
     [[nodiscard]] static std::shared_ptr<PublicationDelegate>
@@ -118,10 +308,63 @@ public:
            const std::vector<std::uint8_t>& priority,
            const std::vector<std::uint16_t>& expiry,
            std::shared_ptr<spdlog::logger> logger,
-           const std::optional<sframe::CipherSuite> cipherSuite);
+           std::shared_ptr<QSFrameContext> sframeContext,
+           std::shared_ptr<BufferPool> bufferPool);
+
+    ~PublicationDelegate();
 
     std::shared_ptr<PublicationDelegate> getptr() { return shared_from_this(); }
 
+    const quicr::Namespace& getNamespace() const { return quicrNamespace; }
+
+    void setPaused(bool value) { paused = value; }
+    bool isPaused() const { return paused; }
+
+    /**
+     * @brief Permanently stops publishing. Waits for an object being
+     *        published on another thread to finish; later objects are dropped.
+     */
+    void invalidate();
+    bool isValid() const { return !removed; }
+
+    /**
+     * @brief Queue objects for the publish pipeline instead of encrypting and
+     *        sending them on the publishing thread. Must be called before
+     *        the first object is published.
+     */
+    void enablePipeline(std::weak_ptr<WorkStealingPool> pool, const PublishPipelineConfig& config);
+
+    PublicationStats getStats() const;
+
+    /**
+     * @brief Derive the encryption keys of the namespace ahead of the first
+     *        object. Slow, call off the media path.
+     */
+    void prepareKeys();
+
+    /**
+     * @brief Release objects to the transport through a token bucket at the
+     *        given bitrate (kbps, 0 leaves the publication unpaced).
+     */
+    void enablePacing(std::weak_ptr<PacedSender> pacer, std::uint32_t bitrate, const PacerConfig& config);
+
+    /**
+     * @brief Changes the paced bitrate (kbps); 0 stops pacing new objects.
+     * @returns False if pacing was not enabled for this publication.
+     */
+    bool setPacingBitrate(std::uint32_t bitrate);
+
+    /**
+     * @brief Sends an object the pacer held back until its release time.
+     */
+    void sendPaced(PacedObject&& object);
+
+    /**
+     * @brief Split objects into fragments of at most size bytes, 0 to send
+     *        them whole. Subscribers must expect fragments as well.
+     */
+    void enableFragmentation(std::size_t size);
+
     /*===========================================================================*/
     // Events
     /*===========================================================================*/
@@ -142,10 +385,180 @@ public:
                             const std::uint8_t* data,
                             std::size_t len,
                             bool groupFlag,
-                            std::vector<qtransport::MethodTraceItem> &&trace);
+                            TraceBuffer&& trace);
+
+    void publishNamedObject(std::shared_ptr<quicr::Client> client,
+                            std::span<const std::uint8_t> data,
+                            bool groupFlag,
+                            TraceBuffer&& trace);
+
+    void publishNamedObject(std::shared_ptr<quicr::Client> client,
+                            quicr::bytes&& data,
+                            bool groupFlag,
+                            TraceBuffer&& trace);
+
+    /**
+     * @brief Publishes a buffer from allocateObjectBuffer, encrypting it in
+     *        place so its storage becomes the wire buffer.
+     */
+    void publishNamedObject(std::shared_ptr<quicr::Client> client,
+                            ObjectBuffer&& data,
+                            bool groupFlag,
+                            TraceBuffer&& trace);
+
+    /**
+     * @brief Allocates a buffer with the header and tag headroom this
+     *        publication needs for in-place encryption.
+     */
+    ObjectBuffer allocateObjectBuffer(std::size_t size) const;
+
+    /**
+     * @brief Publishes a run of objects that all belong to this publication,
+     *        taking the publication lock only once.
+     * @param trace Trace started for the batch; it goes with the first
+     *        object, later ones only carry its start time.
+     */
+    void publishNamedObjects(std::shared_ptr<quicr::Client> client,
+                             std::span<PublishObject> objects,
+                             TraceBuffer&& trace);
 
 private:
-    // bool canPublish;
+    /**
+     * @brief An object that has been named and is ready to be encrypted and sent.
+     */
+    struct PendingObject
+    {
+        std::shared_ptr<quicr::Client> client;
+        quicr::Name name;
+        std::uint8_t priority = 0;
+        std::uint16_t expiry = 0;
+        quicr::bytes data;
+        bool in_place = false;               // data is laid out as [epoch header][payload][tag room]
+        std::size_t header_size = 0;         // only meaningful when in_place
+        std::size_t payload_size = 0;        // only meaningful when in_place
+        TraceBuffer trace;
+    };
+
+    /**
+     * @brief Checks whether an object may be published right now.
+     * @note Caller must hold publish_mutex.
+     */
+    bool canPublish(const std::shared_ptr<quicr::Client>& client, std::size_t size) const;
+
+    /**
+     * @brief Encrypts (if enabled) and sends an owned buffer.
+     * @note Caller must hold publish_mutex and have checked canPublish.
+     */
+    void publishOwned(const std::shared_ptr<quicr::Client>& client,
+                      quicr::bytes&& data,
+                      bool groupFlag,
+                      TraceBuffer&& trace);
+
+    /**
+     * @brief Names and publishes an object buffer, encrypting it in place.
+     * @note Caller must hold publish_mutex and have checked canPublish.
+     */
+    void publishBuffer(const std::shared_ptr<quicr::Client>& client,
+                       ObjectBuffer&& data,
+                       bool groupFlag,
+                       TraceBuffer&& trace);
+
+    /**
+     * @brief Processes a named object right away, or queues it for the
+     *        pipeline worker, applying the drop policy if the queue is full.
+     * @note Caller must hold publish_mutex.
+     */
+    void dispatch(PendingObject&& object, bool groupFlag);
+
+    /**
+     * @brief Encrypts (if enabled) and sends a named object.
+     */
+    void process(PendingObject&& object);
+
+    /**
+     * @brief Makes sure a drain task is queued on the pipeline pool. At most
+     *        one is queued or running at a time, which keeps objects in order.
+     */
+    void scheduleDrain();
+
+    /**
+     * @brief Pipeline task: encrypts and sends a batch of queued objects.
+     */
+    void drainPublishQueue();
+
+    /**
+     * @brief Advances the group/object counters and builds the name of the
+     *        next object, selecting the priority and expiry that apply to it.
+     *        An object whose ids don't fit in the group starts a new group.
+     * @param object_count Object ids to reserve, one per fragment.
+     */
+    quicr::Name nextObjectName(bool groupFlag, std::uint8_t& pri, std::uint16_t& exp, std::size_t object_count = 1);
+
+    /**
+     * @brief Encrypts plaintext into the wire format (epoch + ciphertext).
+     * @returns False if encryption failed and the object must be dropped.
+     */
+    bool encrypt(const quicr::Name& quicrName,
+                 std::span<const std::uint8_t> plaintext,
+                 quicr::bytes& output,
+                 TraceBuffer& trace);
+
+    /**
+     * @brief Splits an object into fragments, each encrypted on its own and
+     *        sent as soon as it is ready, under consecutive object ids
+     *        starting at quicrName.
+     */
+    void sendFragments(const std::shared_ptr<quicr::Client>& client,
+                       const quicr::Name& quicrName,
+                       std::uint8_t pri,
+                       std::uint16_t exp,
+                       std::span<const std::uint8_t> payload,
+                       const TraceBuffer& trace);
+
+    std::size_t fragmentLength(std::size_t size) const;
+    std::size_t fragmentCount(std::size_t size) const;
+
+    /**
+     * @brief Encrypts a buffer laid out as [epoch header][payload][tag room]
+     *        in place, trimming it to the wire size. The payload is moved if
+     *        the epoch's header no longer has the size of header_size.
+     */
+    bool encryptInPlace(const quicr::Name& quicrName,
+                        quicr::bytes& wire,
+                        std::size_t header_size,
+                        std::size_t payload_size,
+                        TraceBuffer& trace);
+
+    /**
+     * @brief The epoch the next object is encrypted with, refreshing
+     *        epoch_header when it changed.
+     * @note Only called where objects are encrypted, which is serialized.
+     */
+    std::uint64_t sealingEpoch();
+
+    /**
+     * @brief Hands an object to the transport, or to the pacer if the
+     *        publication is over its bitrate or objects are already waiting.
+     */
+    void send(std::shared_ptr<quicr::Client> client,
+              const quicr::Name& quicrName,
+              std::uint8_t pri,
+              std::uint16_t exp,
+              quicr::bytes&& data,
+              TraceBuffer&& trace);
+
+    void transmit(const std::shared_ptr<quicr::Client>& client,
+                  const quicr::Name& quicrName,
+                  std::uint8_t pri,
+                  std::uint16_t exp,
+                  quicr::bytes&& data,
+                  TraceBuffer&& trace);
+
+    // Serializes objects of this publication, guarding the name counters.
+    std::mutex publish_mutex;
+    std::atomic<bool> paused = false;
+    std::atomic<bool> removed = false;
+
     std::string sourceId;
     const std::string& originUrl;
     const std::string& authToken;
@@ -161,6 +574,74 @@ private:
     std::shared_ptr<qmedia::QPublicationDelegate> qDelegate;
     const std::shared_ptr<spdlog::logger> logger;
 
-    std::optional<QSFrameContext> sframe_context;
+    // Shared by every delegate of the controller, null when not encrypting.
+    std::shared_ptr<QSFrameContext> sframe_context;
+    std::shared_ptr<BufferPool> buffer_pool;
+
+    // Encoded epoch that prefixes every encrypted object. The encoding is
+    // only touched where objects are encrypted; buffers are laid out ahead
+    // with the size of the latest epoch encrypted with.
+    std::uint64_t header_epoch = 0;
+    quicr::bytes epoch_header;
+    std::atomic<std::size_t> epoch_header_size = 0;
+
+    std::size_t fragment_size = 0;
+
+    // Publish pipeline, only set up when the controller enables it.
+    std::unique_ptr<SPSCQueue<PendingObject>> publish_queue;
+    std::weak_ptr<WorkStealingPool> pipeline_pool;
+    std::atomic<bool> drain_scheduled = false;
+    PublishDropPolicy drop_policy = PublishDropPolicy::drop_group;
+    bool dropping_group = false;        // guarded by publish_mutex
+    std::atomic<std::uint64_t> queued_count = 0;
+    std::atomic<std::uint64_t> dropped_count = 0;
+    std::atomic<std::uint64_t> sent_count = 0;
+
+    // Pacing, only set up when the controller enables it.
+    std::atomic<bool> pacing = false;
+    std::weak_ptr<PacedSender> pacer;
+    std::mutex pacing_mutex;
+    std::optional<TokenBucket> token_bucket;        // guarded by pacing_mutex
+    PacerConfig pacer_config;
+    std::atomic<std::size_t> paced_pending = 0;
+    std::atomic<std::uint64_t> paced_count = 0;
+    std::atomic<std::uint64_t> pacing_delay_total_us = 0;
+    std::atomic<std::uint64_t> pacing_delay_max_us = 0;
+};
+
+/**
+ * @brief Lightweight reference to an active publication.
+ *
+ * Publishing through a handle goes straight to the publication without taking
+ * the controller's publication lock or looking up the namespace. A handle
+ * stays safe to use after the manifest removes its publication; it simply
+ * becomes invalid and further objects are dropped.
+ */
+class PublicationHandle
+{
+public:
+    PublicationHandle() = default;
+
+    bool valid() const { return delegate && delegate->isValid(); }
+    explicit operator bool() const { return valid(); }
+
+    quicr::Namespace quicrNamespace() const { return delegate ? delegate->getNamespace() : quicr::Namespace{}; }
+
+private:
+    friend class QController;
+    explicit PublicationHandle(std::shared_ptr<PublicationDelegate> delegate) : delegate(std::move(delegate)) {}
+
+    std::shared_ptr<PublicationDelegate> delegate;
 };
+
+/**
+ * @brief One entry of a batched publish.
+ */
+struct PublishObject
+{
+    PublicationHandle handle;
+    quicr::bytes data;
+    bool groupFlag = false;
+};
+
 }        // namespace qmedia
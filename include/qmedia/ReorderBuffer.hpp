@@ -0,0 +1,104 @@
+#pragma once
+
+#include <quicr/quicr_common.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace qmedia
+{
+
+struct ReorderBufferConfig
+{
+    // How long an object is held waiting for the objects before it.
+    std::chrono::milliseconds latency = std::chrono::milliseconds(50);
+
+    // Objects held at most; beyond this the earliest is released past its gap.
+    std::size_t max_objects = 256;
+};
+
+struct ReorderBufferStats
+{
+    std::uint64_t in_order;        // Released on arrival
+    std::uint64_t reordered;       // Held until the objects before them arrived
+    std::uint64_t late;            // Arrived after a later object was released, dropped
+    std::uint64_t gaps;            // Releases that gave up on missing objects
+};
+
+/**
+ * @brief Puts received objects back in (group, object) order.
+ *
+ * An object that follows the last released one (the next object of the group,
+ * or object 0 of a later group) is released straight away. Others are held
+ * until the gap before them fills or the latency target expires.
+ *
+ * @note Not thread safe. Only the stats may be read from other threads.
+ */
+class ReorderBuffer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Object
+    {
+        std::uint32_t group_id;
+        std::uint16_t object_id;
+        std::uint8_t priority;
+        quicr::bytes data;
+        Clock::time_point arrival;
+    };
+
+    ReorderBuffer(const ReorderBufferConfig& config = {});
+
+    /**
+     * @brief Adds a received object.
+     * @param released Objects that may be delivered now are appended, in order.
+     */
+    void push(std::uint32_t group_id,
+              std::uint16_t object_id,
+              std::uint8_t priority,
+              quicr::bytes&& data,
+              Clock::time_point now,
+              std::vector<Object>& released);
+
+    /**
+     * @brief Releases held objects whose wait has expired.
+     * @param released Objects that may be delivered now are appended, in order.
+     */
+    void flush(Clock::time_point now, std::vector<Object>& released);
+
+    std::size_t size() const { return held.size(); }
+    ReorderBufferStats getStats() const;
+
+private:
+    struct HeldObject
+    {
+        std::uint8_t priority;
+        quicr::bytes data;
+        Clock::time_point arrival;
+    };
+
+    static std::uint64_t key(std::uint32_t group_id, std::uint16_t object_id)
+    {
+        return std::uint64_t(group_id) << 16 | object_id;
+    }
+
+    bool follows(std::uint64_t object_key) const;
+    void release(std::uint64_t object_key, HeldObject&& object, std::vector<Object>& released);
+
+    const ReorderBufferConfig config;
+
+    std::map<std::uint64_t, HeldObject> held;
+    std::optional<std::uint64_t> last_released;
+
+    std::atomic<std::uint64_t> in_order = 0;
+    std::atomic<std::uint64_t> reordered = 0;
+    std::atomic<std::uint64_t> late = 0;
+    std::atomic<std::uint64_t> gaps = 0;
+};
+
+}        // namespace qmedia
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <vector>
+
+namespace qmedia
+{
+
+/**
+ * @brief Bounded, lock-free single-producer single-consumer ring buffer.
+ *
+ * Producers and consumers may change threads as long as each side is
+ * serialized (e.g. by a mutex or by handing the role over through an atomic
+ * with acquire/release ordering).
+ */
+template<typename T>
+class SPSCQueue
+{
+public:
+    explicit SPSCQueue(std::size_t capacity) : slots(round_up(capacity)), mask(slots.size() - 1) {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /**
+     * @brief Push from the producer. On failure (queue full) value is left
+     *        untouched.
+     */
+    bool push(T&& value)
+    {
+        const auto tail = write_index.load(std::memory_order_relaxed);
+        if (tail - read_index.load(std::memory_order_acquire) == slots.size()) return false;
+
+        slots[tail & mask] = std::move(value);
+        write_index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop from the consumer.
+     */
+    std::optional<T> pop()
+    {
+        const auto head = read_index.load(std::memory_order_relaxed);
+        if (head == write_index.load(std::memory_order_acquire)) return std::nullopt;
+
+        auto value = std::move(slots[head & mask]);
+        slots[head & mask] = T{};
+        read_index.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    std::size_t size() const
+    {
+        return write_index.load(std::memory_order_acquire) - read_index.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return slots.size(); }
+
+private:
+    static std::size_t round_up(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+    // Keep the indices on separate cache lines to avoid false sharing.
+    static constexpr std::size_t Cache_Line_Size = 64;
+
+    std::vector<T> slots;
+    const std::size_t mask;
+    alignas(Cache_Line_Size) std::atomic<std::size_t> write_index = 0;
+    alignas(Cache_Line_Size) std::atomic<std::size_t> read_index = 0;
+};
+
+}        // namespace qmedia
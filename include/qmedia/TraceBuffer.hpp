@@ -0,0 +1,114 @@
+#pragma once
+
+#include <transport/transport.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Method tracing on the publish path. Builds configured with
+// -DQMEDIA_ENABLE_TRACE=OFF compile it out entirely.
+#ifndef QMEDIA_ENABLE_TRACE
+#define QMEDIA_ENABLE_TRACE 1
+#endif
+
+namespace qmedia
+{
+
+/**
+ * @brief Fixed-capacity method trace recorded inline, without allocating,
+ *        while an object moves through qmedia.
+ *
+ * The transport expects a std::vector<qtransport::MethodTraceItem>; it is
+ * only built when the object is handed over. A disabled trace still carries
+ * its start time, which the transport needs as the first item.
+ */
+class TraceBuffer
+{
+public:
+    using TimePoint = std::chrono::time_point<std::chrono::steady_clock, std::chrono::microseconds>;
+
+    static constexpr bool Compiled = QMEDIA_ENABLE_TRACE != 0;
+    static constexpr std::size_t Capacity = 8;
+
+    TraceBuffer() = default;
+
+    /**
+     * @brief Starts a trace at the current time.
+     * @param method Name of the first item; must be a string literal.
+     * @param enabled Whether the following items are recorded.
+     */
+    TraceBuffer(const char* method, bool enabled) :
+        start_time(std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now())),
+        enabled(Compiled && enabled)
+    {
+        items[0] = {method, std::chrono::microseconds::zero()};
+    }
+
+    /**
+     * @brief Records an item. Items past the capacity are dropped.
+     * @param method Must be a string literal, or otherwise outlive the trace.
+     */
+    void add(const char* method)
+    {
+        if constexpr (Compiled)
+        {
+            if (!enabled || count == Capacity) return;
+
+            const auto now = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now());
+            items[count++] = {method, now - start_time};
+        }
+    }
+
+    /**
+     * @brief A trace with the same start time that records nothing, for the
+     *        objects of a batch after the traced one.
+     */
+    TraceBuffer untraced() const
+    {
+        TraceBuffer trace;
+        trace.start_time = start_time;
+        return trace;
+    }
+
+    bool isEnabled() const { return enabled; }
+    std::size_t size() const { return count; }
+    TimePoint startTime() const { return start_time; }
+
+    /**
+     * @brief Builds the trace in the form the transport takes.
+     */
+    std::vector<qtransport::MethodTraceItem> toTransport() const
+    {
+        std::vector<qtransport::MethodTraceItem> trace;
+        if (!enabled)
+        {
+            trace.emplace_back(std::string(), start_time);
+            return trace;
+        }
+
+        // Leave room for the items the transport appends.
+        trace.reserve(count + 4);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto& item = trace.emplace_back(items[i].method, start_time);
+            item.delta = items[i].delta;
+        }
+        return trace;
+    }
+
+private:
+    struct Item
+    {
+        const char* method = nullptr;
+        std::chrono::microseconds delta{};
+    };
+
+    TimePoint start_time;
+    std::array<Item, Capacity> items;
+    std::uint8_t count = 1;
+    bool enabled = false;
+};
+
+}        // namespace qmedia
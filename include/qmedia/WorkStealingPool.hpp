@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qmedia
+{
+
+/**
+ * @brief Fixed set of threads, each with its own task queue. Idle threads
+ *        steal from the others, so uneven load spreads across cores.
+ *
+ * Tasks have no ordering guarantee between each other; callers that need
+ * ordering serialize their work themselves (see PublicationDelegate).
+ */
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(std::size_t threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Queue a task. Called from a pool thread, the task goes to that
+     *        thread's own queue; otherwise queues are picked round-robin.
+     */
+    void submit(Task&& task);
+
+    /**
+     * @brief Stops the threads. Tasks still queued are discarded.
+     */
+    void stop();
+
+    std::size_t size() const { return queues.size(); }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(std::size_t index);
+    bool pop(std::size_t index, Task& task);
+    bool steal(std::size_t index, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> next_queue = 0;
+
+    // Queued tasks; idle threads sleep until it becomes non-zero.
+    std::atomic<std::size_t> pending = 0;
+    std::atomic<std::size_t> sleepers = 0;
+    std::atomic<bool> stopping = false;
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+};
+
+}        // namespace qmedia
@@ -0,0 +1,106 @@
+#include "qmedia/BufferPool.hpp"
+
+#include <algorithm>
+
+namespace qmedia
+{
+// A buffer released into the last class may exceed its capacity by up to this
+// factor; smaller classes are bounded by the next one up.
+constexpr std::size_t Max_Oversize_Factor = 2;
+
+BufferPool::BufferPool(const BufferPoolConfig& config) :
+    max_buffers_per_class(config.max_buffers_per_class),
+    classes(config.size_classes.size())
+{
+    auto capacities = config.size_classes;
+    std::sort(capacities.begin(), capacities.end());
+
+    for (std::size_t i = 0; i < capacities.size(); ++i)
+    {
+        classes[i].capacity = capacities[i];
+        classes[i].buffers.reserve(max_buffers_per_class);
+    }
+}
+
+quicr::bytes BufferPool::acquire(std::size_t size)
+{
+    // Smallest class that fits the request
+    const auto it = std::find_if(
+        classes.begin(), classes.end(), [size](const SizeClass& size_class) { return size_class.capacity >= size; });
+
+    if (it == classes.end())
+    {
+        ++misses;
+        return quicr::bytes(size);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(it->mutex);
+        if (!it->buffers.empty())
+        {
+            auto buffer = std::move(it->buffers.back());
+            it->buffers.pop_back();
+            pooled_bytes -= buffer.capacity();
+            ++hits;
+
+            buffer.resize(size);
+            return buffer;
+        }
+    }
+
+    ++misses;
+    quicr::bytes buffer;
+    buffer.reserve(it->capacity);
+    buffer.resize(size);
+    return buffer;
+}
+
+void BufferPool::release(quicr::bytes&& buffer)
+{
+    const auto capacity = buffer.capacity();
+
+    // Largest class this buffer can serve
+    const auto it = std::find_if(classes.rbegin(), classes.rend(), [capacity](const SizeClass& size_class) {
+        return size_class.capacity <= capacity;
+    });
+
+    // Storage well beyond the last class would stay pinned while pooled.
+    if (it == classes.rend() || (it == classes.rbegin() && capacity > it->capacity * Max_Oversize_Factor))
+    {
+        ++drops;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(it->mutex);
+        if (it->buffers.size() < max_buffers_per_class)
+        {
+            buffer.clear();
+            it->buffers.push_back(std::move(buffer));
+            ++releases;
+
+            const auto pooled = pooled_bytes += capacity;
+            auto high_water = high_water_bytes.load(std::memory_order_relaxed);
+            while (pooled > high_water && !high_water_bytes.compare_exchange_weak(high_water, pooled))
+            {
+            }
+            return;
+        }
+    }
+
+    ++drops;
+}
+
+BufferPool::Stats BufferPool::stats() const
+{
+    return {
+        .hits = hits.load(std::memory_order_relaxed),
+        .misses = misses.load(std::memory_order_relaxed),
+        .releases = releases.load(std::memory_order_relaxed),
+        .drops = drops.load(std::memory_order_relaxed),
+        .pooled_bytes = pooled_bytes.load(std::memory_order_relaxed),
+        .high_water_bytes = high_water_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+}        // namespace qmedia
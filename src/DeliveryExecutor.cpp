@@ -0,0 +1,25 @@
+#include "qmedia/DeliveryExecutor.hpp"
+#include "qmedia/QuicrDelegates.hpp"
+
+#include <algorithm>
+
+namespace qmedia
+{
+
+DeliveryExecutor::DeliveryExecutor(const DeliveryExecutorConfig& config) :
+    config(config), pool(std::make_shared<WorkStealingPool>(std::max<std::size_t>(config.threads, 1)))
+{
+}
+
+DeliveryExecutor::~DeliveryExecutor()
+{
+    // Stopping releases the references queued tasks hold on subscriptions.
+    pool->stop();
+}
+
+void DeliveryExecutor::attach(const std::shared_ptr<SubscriptionDelegate>& delegate)
+{
+    delegate->enableDeliveryExecutor(pool, config);
+}
+
+}        // namespace qmedia
@@ -0,0 +1,72 @@
+#include "qmedia/DuplicateFilter.hpp"
+
+namespace qmedia
+{
+
+bool DuplicateFilter::accept(std::uint32_t group_id, std::uint16_t object_id)
+{
+    if (newest_group && !isNewer(group_id, *newest_group) && *newest_group - group_id >= Restart_Groups)
+    {
+        // Too far back for a replay, the publisher started over.
+        reset();
+    }
+
+    if (!newest_group || isNewer(group_id, *newest_group))
+    {
+        newest_group = group_id;
+    }
+    else if (*newest_group - group_id >= Window_Groups)
+    {
+        return false;
+    }
+
+    // Groups in the window have a slot each; one holding another group holds
+    // a group that has left the window, and is reused.
+    auto& group = groups[group_id % Window_Groups];
+    if (group.group_id != group_id)
+    {
+        group.group_id = group_id;
+        // Ending the bitmap at the first object leaves room for earlier ones arriving late.
+        group.first_object = object_id < Window_Objects ? 0 : object_id - Window_Objects + 1;
+        group.received.fill(0);
+    }
+
+    // Object IDs index the bitmap modulo its size, from first_object up.
+    const auto offset = static_cast<std::uint16_t>(object_id - group.first_object);
+    if (static_cast<std::int16_t>(offset) < 0) return false;
+    if (offset >= Window_Objects)
+    {
+        // Slide forward, forgetting the objects that fall behind.
+        const auto first_object = static_cast<std::uint16_t>(object_id - Window_Objects + 1);
+        const auto shift = static_cast<std::uint16_t>(first_object - group.first_object);
+        if (shift >= Window_Objects)
+        {
+            group.received.fill(0);
+        }
+        else
+        {
+            for (auto forgotten = group.first_object; forgotten != first_object; ++forgotten)
+            {
+                const auto index = forgotten % Window_Objects;
+                group.received[index / Word_Bits] &= ~(std::uint64_t(1) << (index % Word_Bits));
+            }
+        }
+        group.first_object = first_object;
+    }
+
+    const auto index = object_id % Window_Objects;
+    auto& word = group.received[index / Word_Bits];
+    const auto bit = std::uint64_t(1) << (index % Word_Bits);
+    if (word & bit) return false;
+
+    word |= bit;
+    return true;
+}
+
+void DuplicateFilter::reset()
+{
+    newest_group.reset();
+    groups.fill({});
+}
+
+}        // namespace qmedia
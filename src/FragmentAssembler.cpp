@@ -0,0 +1,210 @@
+#include "qmedia/FragmentAssembler.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace qmedia
+{
+
+void FragmentHeader::encode(std::span<std::uint8_t> buffer) const
+{
+    buffer[0] = static_cast<std::uint8_t>(object_length >> 24);
+    buffer[1] = static_cast<std::uint8_t>(object_length >> 16);
+    buffer[2] = static_cast<std::uint8_t>(object_length >> 8);
+    buffer[3] = static_cast<std::uint8_t>(object_length);
+    buffer[4] = static_cast<std::uint8_t>(offset >> 24);
+    buffer[5] = static_cast<std::uint8_t>(offset >> 16);
+    buffer[6] = static_cast<std::uint8_t>(offset >> 8);
+    buffer[7] = static_cast<std::uint8_t>(offset);
+    buffer[8] = static_cast<std::uint8_t>(index >> 8);
+    buffer[9] = static_cast<std::uint8_t>(index);
+}
+
+std::optional<FragmentHeader> FragmentHeader::decode(std::span<const std::uint8_t> buffer)
+{
+    if (buffer.size() < Size) return std::nullopt;
+
+    FragmentHeader header;
+    header.object_length = std::uint32_t(buffer[0]) << 24 | std::uint32_t(buffer[1]) << 16
+                           | std::uint32_t(buffer[2]) << 8 | buffer[3];
+    header.offset = std::uint32_t(buffer[4]) << 24 | std::uint32_t(buffer[5]) << 16 | std::uint32_t(buffer[6]) << 8
+                    | buffer[7];
+    header.index = static_cast<std::uint16_t>(buffer[8] << 8 | buffer[9]);
+    return header;
+}
+
+FragmentAssembler::FragmentAssembler(std::shared_ptr<BufferPool> bufferPool, const FragmentAssemblerConfig& config) :
+    config(config), buffer_pool(std::move(bufferPool))
+{
+}
+
+std::optional<quicr::bytes> FragmentAssembler::add(std::uint64_t object_key,
+                                                   std::size_t object_length,
+                                                   std::size_t offset,
+                                                   std::span<const std::uint8_t> fragment,
+                                                   Clock::time_point now)
+{
+    if (object_length == 0 || object_length > config.max_object_size) return std::nullopt;
+    if (offset > object_length || fragment.size() > object_length - offset) return std::nullopt;
+
+    auto object = find(object_key, object_length, now);
+    if (object == objects.end()) return std::nullopt;
+
+    if (object->ranges.empty()) object->length = object_length;
+    if (object->length != object_length || object->buffer.size() < object_length) return std::nullopt;
+
+    return insert(object, offset, fragment);
+}
+
+std::optional<quicr::bytes> FragmentAssembler::addTransportFragment(std::uint64_t object_key,
+                                                                    std::size_t offset,
+                                                                    bool last,
+                                                                    std::span<const std::uint8_t> fragment,
+                                                                    Clock::time_point now)
+{
+    if (offset > config.max_object_size || fragment.size() > config.max_object_size - offset) return std::nullopt;
+
+    const auto end = offset + fragment.size();
+    if (end == 0) return std::nullopt;
+
+    // Objects of a stream tend to be of similar size, start from the last one.
+    auto object = find(object_key, last ? end : std::max(end, last_object_size), now);
+    if (object == objects.end()) return std::nullopt;
+
+    if (last)
+    {
+        if (object->length != 0 && object->length != end) return std::nullopt;
+        for (const auto& [begin, range_end] : object->ranges)
+        {
+            if (range_end > end) return std::nullopt;
+        }
+        object->length = end;
+    }
+    else if (object->length != 0 && end > object->length)
+    {
+        return std::nullopt;
+    }
+
+    if (!reserve(object, end)) return std::nullopt;
+
+    return insert(object, offset, fragment);
+}
+
+FragmentAssemblerStats FragmentAssembler::getStats() const
+{
+    return {
+        .reassembled = reassembled.load(std::memory_order_relaxed),
+        .abandoned = abandoned.load(std::memory_order_relaxed),
+    };
+}
+
+FragmentAssembler::Iterator
+FragmentAssembler::find(std::uint64_t object_key, std::size_t buffer_size, Clock::time_point now)
+{
+    expire(now);
+
+    auto object = std::find_if(objects.begin(), objects.end(), [&](const auto& o) { return o.key == object_key; });
+    if (object != objects.end()) return object;
+
+    if (buffer_size > config.max_object_size) return objects.end();
+
+    // Make room by giving up on the oldest incomplete objects.
+    if (!objects.empty() && objects.size() >= std::max<std::size_t>(config.max_objects, 1))
+    {
+        abandon(objects.begin());
+    }
+    while (!objects.empty() && buffered_bytes + buffer_size > config.max_buffered_bytes)
+    {
+        abandon(objects.begin());
+    }
+    if (buffered_bytes + buffer_size > config.max_buffered_bytes) return objects.end();
+
+    objects.push_back({
+        .key = object_key,
+        .buffer = buffer_pool->acquire(buffer_size),
+        .length = 0,
+        .received = 0,
+        .ranges = {},
+        .started = now,
+    });
+    buffered_bytes += buffer_size;
+    return std::prev(objects.end());
+}
+
+bool FragmentAssembler::reserve(Iterator& object, std::size_t buffer_size)
+{
+    const auto current = object->buffer.size();
+    if (buffer_size <= current) return true;
+
+    if (buffer_size > config.max_object_size)
+    {
+        abandon(object);
+        return false;
+    }
+
+    // Grow geometrically, the length is still unknown.
+    const auto size = std::min(std::max(buffer_size, current * 2), config.max_object_size);
+    const auto extra = size - current;
+
+    // Erasing at the front leaves the iterator to this object valid.
+    while (objects.begin() != object && buffered_bytes + extra > config.max_buffered_bytes)
+    {
+        abandon(objects.begin());
+    }
+    if (buffered_bytes + extra > config.max_buffered_bytes)
+    {
+        abandon(object);
+        return false;
+    }
+
+    object->buffer.resize(size);
+    buffered_bytes += extra;
+    return true;
+}
+
+std::optional<quicr::bytes>
+FragmentAssembler::insert(Iterator object, std::size_t offset, std::span<const std::uint8_t> fragment)
+{
+    const auto end = offset + fragment.size();
+    for (const auto& [begin, range_end] : object->ranges)
+    {
+        if (offset < range_end && begin < end) return std::nullopt;        // Duplicate
+    }
+
+    if (!fragment.empty())
+    {
+        std::copy(fragment.begin(), fragment.end(), object->buffer.begin() + offset);
+        object->ranges.emplace_back(offset, end);
+        object->received += fragment.size();
+    }
+    if (object->length == 0 || object->received < object->length) return std::nullopt;
+
+    buffered_bytes -= object->buffer.size();
+    last_object_size = object->length;
+
+    auto complete = std::move(object->buffer);
+    complete.resize(object->length);
+    objects.erase(object);
+
+    reassembled.fetch_add(1, std::memory_order_relaxed);
+    return complete;
+}
+
+void FragmentAssembler::abandon(Iterator object)
+{
+    buffered_bytes -= object->buffer.size();
+    buffer_pool->release(std::move(object->buffer));
+    objects.erase(object);
+
+    abandoned.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FragmentAssembler::expire(Clock::time_point now)
+{
+    while (!objects.empty() && now - objects.front().started > config.timeout)
+    {
+        abandon(objects.begin());
+    }
+}
+
+}        // namespace qmedia
@@ -0,0 +1,68 @@
+#include "qmedia/GroupClock.hpp"
+
+#include <algorithm>
+
+namespace qmedia
+{
+
+GroupClock::Clock::duration GroupClock::lateness(std::uint32_t group_id, Clock::time_point now)
+{
+    if (newest_group && !isNewer(group_id, *newest_group) && *newest_group - group_id >= Restart_Groups)
+    {
+        reset();
+    }
+
+    if (!newest_group || isNewer(group_id, *newest_group)) startGroup(group_id, now);
+    if (interval_count < Min_Cadence_Samples) return Clock::duration::zero();
+
+    const auto groups = static_cast<std::int32_t>(group_id - anchor_group);
+    return now - (anchor_start + (groups + 1) * cadence);
+}
+
+void GroupClock::reset()
+{
+    newest_group.reset();
+    interval_count = 0;
+    cadence = last_interval = {};
+}
+
+void GroupClock::startGroup(std::uint32_t group_id, Clock::time_point now)
+{
+    if (!newest_group)
+    {
+        newest_group = group_id;
+        newest_start = anchor_start = now;
+        anchor_group = group_id;
+        return;
+    }
+
+    const auto interval = (now - newest_start) / static_cast<std::int32_t>(group_id - *newest_group);
+    newest_group = group_id;
+    newest_start = now;
+
+    // Groups much closer together than usual are a backlog catching up.
+    const auto learning = interval_count < Min_Cadence_Samples;
+    if (interval > Clock::duration::zero() && (learning || interval >= cadence / 4))
+    {
+        intervals[interval_count++ % Cadence_Samples] = interval;
+
+        auto sorted = intervals;
+        const auto count = std::min(interval_count, Cadence_Samples);
+        std::nth_element(sorted.begin(), sorted.begin() + count / 2, sorted.begin() + count);
+        cadence = sorted[count / 2];
+    }
+
+    const auto due = anchor_start + static_cast<std::int32_t>(group_id - anchor_group) * cadence;
+    const auto on_time = now - due <= cadence;
+    // A pace like the cadence or the last interval, not a stall or a burst.
+    const auto paced = [interval](auto usual) { return interval >= usual / 2 && interval <= usual * 2; };
+    const auto steady = interval >= cadence / 2 && (paced(cadence) || paced(last_interval));
+    last_interval = interval;
+    if (learning || on_time || steady)
+    {
+        anchor_group = group_id;
+        anchor_start = now;
+    }
+}
+
+}        // namespace qmedia
@@ -0,0 +1,64 @@
+#include "qmedia/LayerAdaptation.hpp"
+
+#include <algorithm>
+
+namespace qmedia
+{
+
+LayerAdaptation::LayerAdaptation(const LayerAdaptationConfig& config,
+                                 std::vector<std::uint32_t> bitrates,
+                                 std::size_t initial_layer,
+                                 Clock::time_point now) :
+    config(config),
+    bitrates(std::move(bitrates)),
+    layer(std::min(initial_layer, this->bitrates.empty() ? 0 : this->bitrates.size() - 1)),
+    max_layer(this->bitrates.empty() ? 0 : this->bitrates.size() - 1),
+    clean_since(now)
+{
+}
+
+std::optional<std::size_t> LayerAdaptation::update(const LayerSample& sample, Clock::time_point now)
+{
+    if (layer > max_layer) return max_layer;
+
+    const auto expected = bitrates.empty() ? 0.0 : double(bitrates[layer]);
+    const auto starved = config.down_throughput > 0 && expected > 0
+                         && sample.throughput_kbps < config.down_throughput * expected;
+    if (sample.loss > config.down_loss || starved)
+    {
+        clean_since = now;
+        if (++bad_samples >= config.down_samples && layer > 0)
+        {
+            bad_samples = 0;
+            return layer - 1;
+        }
+        return std::nullopt;
+    }
+
+    bad_samples = 0;
+    if (sample.loss > config.up_loss)
+    {
+        clean_since = now;
+        return std::nullopt;
+    }
+
+    if (layer < max_layer && now - clean_since >= config.up_hold) return layer + 1;
+
+    return std::nullopt;
+}
+
+void LayerAdaptation::switched(std::size_t new_layer, Clock::time_point now)
+{
+    layer = new_layer;
+    bad_samples = 0;
+
+    // A fresh layer has to prove itself before stepping up again.
+    clean_since = now;
+}
+
+void LayerAdaptation::setMaxLayer(std::size_t new_max_layer)
+{
+    max_layer = bitrates.empty() ? 0 : std::min(new_max_layer, bitrates.size() - 1);
+}
+
+}        // namespace qmedia
@@ -0,0 +1,239 @@
+#include "qmedia/LossTracker.hpp"
+
+#include <algorithm>
+
+namespace qmedia
+{
+namespace
+{
+// Ranges of objects tracked per group; beyond this the lowest hole is settled.
+constexpr std::size_t Max_Holes = 64;
+}        // namespace
+
+std::uint32_t LossTracker::Group::holeBefore(std::size_t range) const
+{
+    const auto previous_end = range == 0 ? first_object : received[range - 1].end;
+    return received[range].begin - previous_end;
+}
+
+LossTracker::LossTracker(const LossTrackerConfig& config) : config(config)
+{
+    tracked.reserve(config.groups);
+}
+
+void LossTracker::add(std::uint32_t group_id,
+                      std::uint16_t object_id,
+                      Clock::time_point now,
+                      std::vector<std::uint32_t>& incomplete)
+{
+    if (newest_group && std::min(group_id - *newest_group, *newest_group - group_id) >= Restart_Groups)
+    {
+        // Too far from the stream for loss or reordering: the publisher
+        // started over, e.g. with group IDs from the clock after a pause.
+        restart(incomplete);
+    }
+
+    if (!newest_group || isNewer(group_id, *newest_group))
+    {
+        if (newest_group)
+        {
+            // Skipped groups may still be on their way, e.g. on another stream.
+            // Those beyond the window could not be told apart from old ones.
+            const auto skipped = std::uint64_t(group_id - *newest_group - 1);
+            const auto placeholders = std::min<std::uint64_t>(skipped, config.groups);
+            lost_groups.fetch_add(skipped - placeholders, std::memory_order_relaxed);
+            for (auto back = static_cast<std::uint32_t>(placeholders); back > 0; --back)
+            {
+                track({.group_id = group_id - back, .hole_since = now}, incomplete);
+            }
+        }
+
+        // Objects before the first one received are not expected, the subscription started there.
+        track({.group_id = group_id, .first_object = newest_group ? 0u : object_id}, incomplete);
+        newest_group = group_id;
+    }
+
+    // Too old to know whether it fills a hole.
+    auto* group = find(group_id);
+    if (group) receive(*group, object_id, now);
+
+    for (auto& tracked_group : tracked)
+    {
+        if (tracked_group.hole_since && now - *tracked_group.hole_since >= config.reorder_window)
+        {
+            report(tracked_group, now, false, incomplete);
+        }
+    }
+}
+
+LossStats LossTracker::getStats() const
+{
+    return {
+        .groups = group_count.load(std::memory_order_relaxed),
+        .lost_objects = lost_objects.load(std::memory_order_relaxed),
+        .lost_groups = lost_groups.load(std::memory_order_relaxed),
+        .reordered = reordered.load(std::memory_order_relaxed),
+        .recovered = recovered.load(std::memory_order_relaxed),
+        .incomplete_groups = incomplete_groups.load(std::memory_order_relaxed),
+    };
+}
+
+void LossTracker::receive(Group& group, std::uint32_t object_id, Clock::time_point now)
+{
+    auto& ranges = group.received;
+    if (ranges.empty())
+    {
+        group_count.fetch_add(1, std::memory_order_relaxed);
+        if (group.reported)
+        {
+            // The whole group was reported lost.
+            recovered.fetch_add(1, std::memory_order_relaxed);
+            lost_groups.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // A skipped group's first objects have been missing since it was skipped.
+        const auto hole_since = group.hole_since.value_or(now);
+        group.first_object = std::min(group.first_object, object_id);
+        ranges.push_back({.begin = object_id, .end = object_id + 1, .hole_since = hole_since});
+        group.hole_since = group.holeBefore(0) > 0 ? std::optional(hole_since) : std::nullopt;
+        return;
+    }
+
+    // Earlier than the subscription started, not expected.
+    if (object_id < group.first_object)
+    {
+        reordered.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Past the highest object, possibly opening a hole.
+    if (object_id >= ranges.back().end)
+    {
+        if (object_id == ranges.back().end)
+        {
+            ++ranges.back().end;
+            return;
+        }
+
+        ranges.push_back({.begin = object_id, .end = object_id + 1, .hole_since = now});
+        if (!group.hole_since) group.hole_since = now;
+    }
+    else
+    {
+        // Within a hole, or seen before.
+        const auto next = std::upper_bound(ranges.begin(), ranges.end(), object_id, [](auto object, const auto& range) {
+            return object < range.begin;
+        });
+        if (next != ranges.begin() && object_id < std::prev(next)->end) return;
+
+        reordered.fetch_add(1, std::memory_order_relaxed);
+        if (next->hole_reported)
+        {
+            recovered.fetch_add(1, std::memory_order_relaxed);
+            lost_objects.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        const auto follows = next != ranges.begin() && std::prev(next)->end == object_id;
+        const auto precedes = object_id + 1 == next->begin;
+        if (follows && precedes)
+        {
+            std::prev(next)->end = next->end;
+            ranges.erase(next);
+        }
+        else if (follows)
+        {
+            ++std::prev(next)->end;
+        }
+        else if (precedes)
+        {
+            --next->begin;
+        }
+        else
+        {
+            // The hole splits, both sides keep its state.
+            ranges.insert(next, {object_id, object_id + 1, next->hole_since, next->hole_reported});
+        }
+    }
+
+    if (ranges.size() > Max_Holes)
+    {
+        // Settle the lowest hole between ranges; objects still arriving for
+        // it are taken for duplicates.
+        const auto hole = ranges.begin() + 1;
+        if (!hole->hole_reported) lost_objects.fetch_add(group.holeBefore(1), std::memory_order_relaxed);
+
+        ranges.front().end = hole->end;
+        ranges.erase(hole);
+    }
+}
+
+void LossTracker::restart(std::vector<std::uint32_t>& incomplete)
+{
+    // Holes from before the restart will not be filled any more.
+    for (auto& group : tracked)
+    {
+        if (group.hole_since) report(group, Clock::time_point::max(), true, incomplete);
+    }
+
+    tracked.clear();
+    newest_group.reset();
+}
+
+LossTracker::Group* LossTracker::find(std::uint32_t group_id)
+{
+    // Recent groups are the likely ones.
+    const auto it = std::find_if(
+        tracked.rbegin(), tracked.rend(), [group_id](const auto& group) { return group.group_id == group_id; });
+    return it == tracked.rend() ? nullptr : &*it;
+}
+
+void LossTracker::track(Group&& group, std::vector<std::uint32_t>& incomplete)
+{
+    if (!tracked.empty() && tracked.size() >= config.groups)
+    {
+        // Settle the oldest group, a hole in it will not be filled in time now.
+        auto& oldest = tracked.front();
+        if (oldest.hole_since) report(oldest, Clock::time_point::max(), true, incomplete);
+        tracked.erase(tracked.begin());
+    }
+
+    tracked.push_back(std::move(group));
+}
+
+void LossTracker::report(Group& group, Clock::time_point now, bool settle, std::vector<std::uint32_t>& incomplete)
+{
+    auto reported = false;
+    group.hole_since.reset();
+
+    if (group.received.empty())
+    {
+        lost_groups.fetch_add(1, std::memory_order_relaxed);
+        reported = true;
+    }
+
+    for (std::size_t range = 0; range < group.received.size(); ++range)
+    {
+        auto& hole = group.received[range];
+        const auto missing = group.holeBefore(range);
+        if (missing == 0 || hole.hole_reported) continue;
+
+        if (!settle && now - hole.hole_since < config.reorder_window)
+        {
+            // Not due yet, the next oldest hole.
+            if (!group.hole_since || hole.hole_since < *group.hole_since) group.hole_since = hole.hole_since;
+            continue;
+        }
+
+        hole.hole_reported = true;
+        lost_objects.fetch_add(missing, std::memory_order_relaxed);
+        reported = true;
+    }
+
+    if (!reported) return;
+
+    if (!group.reported) incomplete_groups.fetch_add(1, std::memory_order_relaxed);
+    group.reported = true;
+    incomplete.push_back(group.group_id);
+}
+
+}        // namespace qmedia
@@ -1,5 +1,8 @@
 #include <qmedia/ManifestTypes.hpp>
 
+#include <charconv>
+#include <string_view>
+
 namespace qmedia::manifest
 {
 
@@ -74,6 +77,44 @@ bool operator==(const Profile& lhs, const Profile& rhs)
            lhs.priorities == rhs.priorities && lhs.expiry == rhs.expiry;
 }
 
+QualityProfile QualityProfile::parse(const std::string& qualityProfile)
+{
+    QualityProfile profile;
+
+    std::string_view remaining = qualityProfile;
+    bool first = true;
+    while (!remaining.empty())
+    {
+        const auto comma = remaining.find(',');
+        const auto field = remaining.substr(0, comma);
+        remaining = comma == std::string_view::npos ? std::string_view{} : remaining.substr(comma + 1);
+
+        const auto equals = field.find('=');
+        if (equals == std::string_view::npos)
+        {
+            // The codec is the leading field without a value.
+            if (first) profile.codec = field;
+            first = false;
+            continue;
+        }
+        first = false;
+
+        const auto key = field.substr(0, equals);
+        const auto value = field.substr(equals + 1);
+
+        std::uint32_t number = 0;
+        if (std::from_chars(value.data(), value.data() + value.size(), number).ec != std::errc{}) continue;
+
+        if (key == "width") profile.width = number;
+        else if (key == "height") profile.height = number;
+        else if (key == "fps") profile.fps = number;
+        else if (key == "br") profile.bitrate = number;
+        else if (key == "frag") profile.fragment_size = number;
+    }
+
+    return profile;
+}
+
 bool operator==(const ProfileSet& lhs, const ProfileSet& rhs)
 {
     return lhs.type == rhs.type && lhs.profiles == rhs.profiles;
@@ -0,0 +1,40 @@
+#include "qmedia/ObjectBuffer.hpp"
+
+namespace qmedia
+{
+ObjectBuffer::ObjectBuffer(std::size_t header_size, std::size_t payload_size, std::size_t trailer_size) :
+    storage(header_size + payload_size + trailer_size),
+    header_size(header_size),
+    trailer_size(trailer_size),
+    payload_size(payload_size)
+{
+}
+
+ObjectBuffer::ObjectBuffer(quicr::bytes&& storage,
+                           std::size_t header_size,
+                           std::size_t payload_size,
+                           std::size_t trailer_size) :
+    storage(std::move(storage)),
+    header_size(header_size),
+    trailer_size(trailer_size),
+    payload_size(payload_size)
+{
+    this->storage.resize(header_size + payload_size + trailer_size);
+}
+
+bool ObjectBuffer::resize(std::size_t size)
+{
+    if (size > capacity()) return false;
+    payload_size = size;
+    return true;
+}
+
+quicr::bytes ObjectBuffer::release() &&
+{
+    header_size = 0;
+    trailer_size = 0;
+    payload_size = 0;
+    return std::move(storage);
+}
+
+}        // namespace qmedia
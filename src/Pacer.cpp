@@ -0,0 +1,141 @@
+#include "qmedia/Pacer.hpp"
+#include "qmedia/QuicrDelegates.hpp"
+
+#include <algorithm>
+
+namespace qmedia
+{
+
+namespace
+{
+// Orders the heap so the earliest release is at the front, ties in the order
+// the objects were queued.
+bool releases_later(const PacedObject& lhs, const PacedObject& rhs)
+{
+    if (lhs.release_time != rhs.release_time) return lhs.release_time > rhs.release_time;
+    return lhs.sequence > rhs.sequence;
+}
+}        // namespace
+
+TokenBucket::TokenBucket(double bytes_per_second, std::chrono::microseconds burst) :
+    rate(bytes_per_second),
+    burst(burst),
+    capacity(rate * std::chrono::duration<double>(burst).count()),
+    tokens(capacity),
+    last_refill(Clock::now())
+{
+}
+
+void TokenBucket::setRate(double bytes_per_second)
+{
+    refill(Clock::now());
+    rate = bytes_per_second;
+    capacity = rate * std::chrono::duration<double>(burst).count();
+    tokens = std::min(tokens, capacity);
+}
+
+void TokenBucket::refill(Clock::time_point now)
+{
+    if (now <= last_refill) return;
+
+    tokens = std::min(capacity, tokens + rate * std::chrono::duration<double>(now - last_refill).count());
+    last_refill = now;
+}
+
+TokenBucket::Clock::time_point TokenBucket::schedule(std::size_t size, Clock::time_point now)
+{
+    refill(now);
+
+    auto release_time = now;
+    if (rate > 0)
+    {
+        const auto deficit = static_cast<double>(size) - tokens;
+        tokens -= static_cast<double>(size);
+        if (deficit > 0)
+        {
+            release_time += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(deficit / rate));
+        }
+    }
+
+    // Objects scheduled at a slower rate must not be overtaken.
+    release_time = std::max(release_time, last_release);
+    last_release = release_time;
+    return release_time;
+}
+
+PacedSender::PacedSender() : thread(&PacedSender::run, this)
+{
+}
+
+PacedSender::~PacedSender()
+{
+    stop();
+}
+
+void PacedSender::enqueue(PacedObject&& object)
+{
+    bool earliest;
+    {
+        const std::lock_guard<std::mutex> _(mutex);
+        if (stopping) return;
+
+        const auto sequence = next_sequence++;
+        object.sequence = sequence;
+        heap.push_back(std::move(object));
+        std::push_heap(heap.begin(), heap.end(), releases_later);
+        earliest = heap.front().sequence == sequence;
+    }
+
+    // Only a new earliest object changes when the thread has to wake up.
+    if (earliest) cv.notify_one();
+}
+
+void PacedSender::stop()
+{
+    {
+        const std::lock_guard<std::mutex> _(mutex);
+        if (stopping) return;
+        stopping = true;
+    }
+    cv.notify_one();
+
+    if (thread.joinable()) thread.join();
+    heap.clear();
+}
+
+std::size_t PacedSender::size() const
+{
+    const std::lock_guard<std::mutex> _(mutex);
+    return heap.size();
+}
+
+void PacedSender::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        if (heap.empty())
+        {
+            cv.wait(lock);
+            continue;
+        }
+
+        const auto release_time = heap.front().release_time;
+        if (release_time > TokenBucket::Clock::now())
+        {
+            cv.wait_until(lock, release_time);
+            continue;
+        }
+
+        std::pop_heap(heap.begin(), heap.end(), releases_later);
+        auto object = std::move(heap.back());
+        heap.pop_back();
+
+        lock.unlock();
+        auto publication = std::move(object.publication);
+        publication->sendPaced(std::move(object));
+        lock.lock();
+    }
+}
+
+}        // namespace qmedia
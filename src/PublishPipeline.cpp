@@ -0,0 +1,28 @@
+#include "qmedia/PublishPipeline.hpp"
+#include "qmedia/QuicrDelegates.hpp"
+
+#include <thread>
+
+namespace qmedia
+{
+
+PublishPipeline::PublishPipeline(const PublishPipelineConfig& config) :
+    config(config),
+    pool(std::make_shared<WorkStealingPool>(config.worker_threads ? config.worker_threads
+                                                                  : std::thread::hardware_concurrency()))
+{
+}
+
+PublishPipeline::~PublishPipeline()
+{
+    // Publications may outlive the pipeline through their handles; stopping
+    // here releases the references queued tasks hold on them.
+    pool->stop();
+}
+
+void PublishPipeline::attach(const std::shared_ptr<PublicationDelegate>& delegate)
+{
+    delegate->enablePipeline(pool, config);
+}
+
+}        // namespace qmedia
@@ -3,9 +3,13 @@
 #include "qmedia/ManifestTypes.hpp"
 
 #include <quicr/hex_endec.h>
+#include <sframe/crypto.h>
 
+#include <algorithm>
 #include <iostream>
+#include <set>
 #include <sstream>
+#include <utility>
 
 #define LOGGER_TRACE(logger, ...) if (logger) SPDLOG_LOGGER_TRACE(logger, __VA_ARGS__)
 #define LOGGER_DEBUG(logger, ...) if (logger) SPDLOG_LOGGER_DEBUG(logger, __VA_ARGS__)
@@ -17,17 +21,35 @@
 namespace qmedia
 {
 
+namespace
+{
+void setProfileDeadline(SubscriptionDelegate& delegate, const manifest::Profile& profile)
+{
+    // Objects past the publication's expiry are of no use to the decoder.
+    const auto expiry = std::max_element(profile.expiry.begin(), profile.expiry.end());
+    if (expiry != profile.expiry.end()) delegate.setDeadline(std::chrono::milliseconds(*expiry));
+}
+
+// Whether the publication's objects are fragmented is up to its profile, not to this participant.
+std::size_t profileFragmentSize(const manifest::Profile& profile)
+{
+    return manifest::QualityProfile::parse(profile.qualityProfile).fragment_size;
+}
+}        // namespace
+
 QController::QController(std::shared_ptr<QSubscriberDelegate> qSubscriberDelegate,
                          std::shared_ptr<QPublisherDelegate> qPublisherDelegate,
                          std::shared_ptr<spdlog::logger> logger,
                          const bool debugging,
-                         const std::optional<sframe::CipherSuite> cipher_suite) :
+                         const std::optional<sframe::CipherSuite> cipher_suite,
+                         const BufferPoolConfig& bufferPoolConfig) :
     logger(std::move(logger)),
     qSubscriberDelegate(std::move(qSubscriberDelegate)),
     qPublisherDelegate(std::move(qPublisherDelegate)),
+    buffer_pool(std::make_shared<BufferPool>(bufferPoolConfig)),
+    tracing(debugging),
     stop(false),
-    closed(false),
-    cipher_suite(cipher_suite)
+    closed(false)
 {
     // If there's a parent logger, its log level will be used.
     // Otherwise, query the debugging flag.
@@ -38,6 +60,21 @@ QController::QController(std::shared_ptr<QSubscriberDelegate> qSubscriberDelegat
 
     LOGGER_DEBUG(this->logger, "QController started...");
 
+    if (cipher_suite)
+    {
+        // One context for every delegate, so each key is derived once.
+        // TODO: This needs to be replaced with valid keying material
+        std::string salt_string = "Quicr epoch master key " + std::to_string(Fixed_Epoch);
+        sframe::bytes salt(salt_string.begin(), salt_string.end());
+        auto epoch_key = sframe::hkdf_extract(
+            *cipher_suite,
+            salt,
+            {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f});
+        sframe_context = std::make_shared<QSFrameContext>(*cipher_suite);
+        sframe_context->addEpoch(Fixed_Epoch, epoch_key);
+        sframe_context->enableEpoch(Fixed_Epoch);
+    }
+
     // quicr://webex.cisco.com/conference/1/mediaType/192/endpoint/2
     //   org, app,   conf, media, endpoint,     group, object
     //   24,   8,      24,     8,       16,        32,     16
@@ -51,6 +88,26 @@ QController::QController(std::shared_ptr<QSubscriberDelegate> qSubscriberDelegat
 
 QController::~QController()
 {
+    // Warm-ups first, they may start the epoch retirement thread.
+    {
+        std::lock_guard<std::mutex> _(warmupsMutex);
+        warmups_stop = true;
+    }
+    warmups_cv.notify_all();
+    if (warmup_thread.joinable()) warmup_thread.join();
+
+    // Stop the workers first so nothing is sent while disconnecting.
+    publish_pipeline.reset();
+    delivery_executor.reset();
+    if (paced_sender) paced_sender->stop();
+    {
+        std::lock_guard<std::mutex> _(periodic_mutex);
+        periodic_stop = true;
+    }
+    periodic_cv.notify_all();
+    if (reorder_thread.joinable()) reorder_thread.join();
+    if (adaptation_thread.joinable()) adaptation_thread.join();
+    if (epoch_thread.joinable()) epoch_thread.join();
     disconnect();
 }
 
@@ -126,24 +183,418 @@ void QController::publishNamedObject(const quicr::Namespace& quicrNamespace,
                                      const std::uint8_t* data,
                                      std::size_t len,
                                      bool groupFlag)
+{
+    publishNamedObject(quicrNamespace, std::span<const std::uint8_t>(data, len), groupFlag);
+}
+
+void QController::publishNamedObject(const quicr::Namespace& quicrNamespace,
+                                     std::span<const std::uint8_t> data,
+                                     bool groupFlag)
+{
+    publishNamedObject(getPublicationHandle(quicrNamespace), data, groupFlag);
+}
+
+void QController::publishNamedObject(const quicr::Namespace& quicrNamespace, quicr::bytes&& data, bool groupFlag)
+{
+    publishNamedObject(getPublicationHandle(quicrNamespace), std::move(data), groupFlag);
+}
+
+void QController::publishNamedObject(const quicr::Namespace& quicrNamespace, ObjectBuffer&& data, bool groupFlag)
+{
+    publishNamedObject(getPublicationHandle(quicrNamespace), std::move(data), groupFlag);
+}
+
+ObjectBuffer QController::allocateObjectBuffer(const quicr::Namespace& quicrNamespace, std::size_t size)
+{
+    return allocateObjectBuffer(getPublicationHandle(quicrNamespace), size);
+}
+
+void QController::setPublishPipeline(const PublishPipelineConfig& config)
+{
+    std::lock_guard<std::mutex> _(pubsMutex);
+    if (!quicrPublicationsMap.empty())
+    {
+        LOGGER_WARN(logger, "Publish pipeline must be set before any publication is created");
+        return;
+    }
+
+    publish_pipeline = std::make_unique<PublishPipeline>(config);
+}
+
+void QController::setPacing(const PacerConfig& config)
+{
+    std::lock_guard<std::mutex> _(pubsMutex);
+    if (!quicrPublicationsMap.empty())
+    {
+        LOGGER_WARN(logger, "Pacing must be set before any publication is created");
+        return;
+    }
+
+    pacer_config = config;
+    if (!paced_sender) paced_sender = std::make_shared<PacedSender>();
+}
+
+bool QController::setPublicationBitrate(const quicr::Namespace& quicrNamespace, std::uint32_t bitrate)
+{
+    const auto handle = getPublicationHandle(quicrNamespace);
+    if (!handle.delegate) return false;
+
+    return handle.delegate->setPacingBitrate(bitrate);
+}
+
+void QController::setReorderBuffer(const ReorderBufferConfig& config)
+{
+    std::lock_guard<std::mutex> _(subsMutex);
+    if (!quicrSubscriptionsMap.empty() || reorder_config)
+    {
+        LOGGER_WARN(logger, "Reorder buffer must be set once, before any subscription is created");
+        return;
+    }
+
+    reorder_config = config;
+
+    // Check a few times per latency target, so objects are released close to on time.
+    const auto interval = std::max(std::chrono::milliseconds(1), config.latency / 4);
+    reorder_thread = std::thread(&QController::runReorderFlush, this, interval);
+}
+
+void QController::setDeliveryExecutor(const DeliveryExecutorConfig& config)
+{
+    std::lock_guard<std::mutex> _(subsMutex);
+    if (!quicrSubscriptionsMap.empty())
+    {
+        LOGGER_WARN(logger, "Delivery executor must be set before any subscription is created");
+        return;
+    }
+
+    delivery_executor = std::make_unique<DeliveryExecutor>(config);
+}
+
+SubscriptionStats QController::getSubscriptionStats(const quicr::Namespace& quicrNamespace)
+{
+    const auto delegate = findQuicrSubscriptionDelegate(quicrNamespace);
+    if (!delegate) return {};
+
+    return delegate->getStats();
+}
+
+bool QController::setSubscriptionMaxLatency(const quicr::Namespace& quicrNamespace,
+                                            std::chrono::milliseconds latency)
+{
+    const auto delegate = findQuicrSubscriptionDelegate(quicrNamespace);
+    if (!delegate) return false;
+
+    delegate->setDeadline(latency);
+    return true;
+}
+
+SubscriptionStats QController::getSourceStats(const SourceId& sourceId)
+{
+    auto delegates = std::vector<std::shared_ptr<SubscriptionDelegate>>();
+    {
+        std::lock_guard<std::mutex> _(subsMutex);
+        for (const auto& [quicrNamespace, delegate] : quicrSubscriptionsMap)
+        {
+            if (delegate->getSourceId() == sourceId) delegates.push_back(delegate);
+        }
+    }
+
+    SubscriptionStats stats;
+    for (const auto& delegate : delegates)
+    {
+        stats += delegate->getStats();
+    }
+    return stats;
+}
+
+void QController::runReorderFlush(std::chrono::milliseconds interval)
+{
+    auto subscriptions = std::vector<std::shared_ptr<SubscriptionDelegate>>();
+
+    std::unique_lock<std::mutex> lock(periodic_mutex);
+    while (!periodic_cv.wait_for(lock, interval, [this] { return periodic_stop; }))
+    {
+        lock.unlock();
+        {
+            // Flush outside the map lock, delivery calls into the application.
+            std::lock_guard<std::mutex> _(subsMutex);
+            for (const auto& [quicrNamespace, delegate] : quicrSubscriptionsMap)
+            {
+                subscriptions.push_back(delegate);
+            }
+        }
+
+        for (const auto& delegate : subscriptions)
+        {
+            delegate->flushReorderBuffer();
+        }
+        subscriptions.clear();
+        lock.lock();
+    }
+}
+
+void QController::setLayerAdaptation(const LayerAdaptationConfig& config)
+{
+    std::lock_guard<std::mutex> _(subsMutex);
+    if (!quicrSubscriptionsMap.empty() || adaptation_config)
+    {
+        LOGGER_WARN(logger, "Layer adaptation must be set once, before any subscription is created");
+        return;
+    }
+
+    adaptation_config = config;
+    const auto interval = std::max(std::chrono::milliseconds(1), config.interval);
+    adaptation_thread = std::thread(&QController::runLayerAdaptation, this, interval);
+}
+
+bool QController::setMaxLayer(const SourceId& sourceId, std::size_t layer)
+{
+    std::lock_guard<std::mutex> _(layersMutex);
+    const auto it = layerSets.find(sourceId);
+    if (it == layerSets.end()) return false;
+
+    it->second.adaptation.setMaxLayer(layer);
+    return true;
+}
+
+std::optional<std::size_t> QController::getLayer(const SourceId& sourceId)
+{
+    std::lock_guard<std::mutex> _(layersMutex);
+    const auto it = layerSets.find(sourceId);
+    if (it == layerSets.end()) return std::nullopt;
+
+    return it->second.adaptation.getLayer();
+}
+
+void QController::runLayerAdaptation(std::chrono::milliseconds interval)
+{
+    std::unique_lock<std::mutex> lock(periodic_mutex);
+    while (!periodic_cv.wait_for(lock, interval, [this] { return periodic_stop; }))
+    {
+        lock.unlock();
+        {
+            const auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> _(layersMutex);
+            for (auto& [sourceId, set] : layerSets)
+            {
+                adaptLayers(sourceId, set, now);
+            }
+        }
+        lock.lock();
+    }
+}
+
+void QController::adaptLayers(const SourceId& sourceId, LayerSet& set, std::chrono::steady_clock::time_point now)
+{
+    const auto& current = set.layers[set.adaptation.getLayer()];
+    if (set.pending)
+    {
+        const auto& next = set.layers[*set.pending];
+        const auto delegate = findQuicrSubscriptionDelegate(next.quicrNamespace);
+        if (delegate && delegate->isDelivering())
+        {
+            // The new layer has taken over, the old one only costs bandwidth now.
+            stopSubscription(current.quicrNamespace);
+            set.adaptation.switched(*set.pending, now);
+            set.last = delegate->getStats();
+            set.pending.reset();
+        }
+        else if (now - set.pending_since >= adaptation_config->switch_timeout)
+        {
+            LOGGER_WARN(logger, "No group started on {0}, staying on {1}",
+                        std::string(next.quicrNamespace), std::string(current.quicrNamespace));
+            if (delegate) stopSubscription(next.quicrNamespace);
+            set.pending.reset();
+        }
+        return;
+    }
+
+    const auto delegate = findQuicrSubscriptionDelegate(current.quicrNamespace);
+    if (!delegate) return;
+
+    const auto stats = delegate->getStats();
+    // Losses can be taken back when late objects turn up.
+    const auto lost = [](const SubscriptionStats& stats) {
+        return static_cast<std::int64_t>(stats.loss.lost_objects + stats.loss.lost_groups);
+    };
+    const auto objects = stats.objects - set.last.objects;
+    const auto gaps = static_cast<std::uint64_t>(std::max<std::int64_t>(0, lost(stats) - lost(set.last)));
+    const auto bytes = stats.bytes - set.last.bytes;
+    set.last = stats;
+
+    // Nothing was published, which says nothing about the path.
+    if (objects == 0 && gaps == 0) return;
+
+    const auto interval = std::chrono::duration<double>(adaptation_config->interval).count();
+    const auto sample = LayerSample{
+        .loss = double(gaps) / double(objects + gaps),
+        .throughput_kbps = interval > 0 ? double(bytes) * 8 / interval / 1000 : 0,
+    };
+
+    if (const auto layer = set.adaptation.update(sample, now))
+    {
+        startLayerSwitch(sourceId, set, *layer, now);
+    }
+}
+
+void QController::startLayerSwitch(const SourceId& sourceId,
+                                   LayerSet& set,
+                                   std::size_t layer,
+                                   std::chrono::steady_clock::time_point now)
+{
+    const auto& current = set.layers[set.adaptation.getLayer()];
+    const auto& next = set.layers[layer];
+
+    quicr::bytes e2eToken;
+    const auto delegate = createQuicrSubscriptionDelegate(sourceId,
+                                                          next.quicrNamespace,
+                                                          quicr::SubscribeIntent::sync_up,
+                                                          "",
+                                                          set.transportMode,
+                                                          "",
+                                                          std::move(e2eToken),
+                                                          set.qDelegate,
+                                                          profileFragmentSize(next) > 0);
+    if (!delegate)
+    {
+        LOGGER_ERROR(logger, "Failed to create Subscription delegate for {0}", std::string(next.quicrNamespace));
+        return;
+    }
+
+    // Make before break: the current layer keeps delivering until the new one starts a group.
+    delegate->replaceLayer(findQuicrSubscriptionDelegate(current.quicrNamespace));
+    setProfileDeadline(*delegate, next);
+    delegate->subscribe(client_session, set.transportMode);
+
+    set.pending = layer;
+    set.pending_since = now;
+    LOGGER_INFO(logger, "Switching {0} from {1} to {2}",
+                sourceId, std::string(current.quicrNamespace), std::string(next.quicrNamespace));
+}
+
+void QController::startAdaptiveSubscription(std::shared_ptr<QSubscriptionDelegate> qDelegate,
+                                            const SourceId& sourceId,
+                                            const manifest::ProfileSet& profileSet,
+                                            const quicr::TransportMode transportMode)
+{
+    // Layers without a bitrate keep their manifest order.
+    auto layers = profileSet.profiles;
+    auto bitrates = std::vector<std::uint32_t>();
+    std::stable_sort(layers.begin(), layers.end(), [](const auto& lhs, const auto& rhs) {
+        return manifest::QualityProfile::parse(lhs.qualityProfile).bitrate
+               < manifest::QualityProfile::parse(rhs.qualityProfile).bitrate;
+    });
+    for (const auto& layer : layers)
+    {
+        bitrates.push_back(manifest::QualityProfile::parse(layer.qualityProfile).bitrate);
+    }
+
+    // Start on the profile the manifest lists first, as without adaptation.
+    const auto initial = static_cast<std::size_t>(std::distance(
+        layers.begin(), std::find(layers.begin(), layers.end(), profileSet.profiles.front())));
+
+    quicr::bytes e2eToken;
+    if (startSubscription(qDelegate,
+                          sourceId,
+                          layers[initial].quicrNamespace,
+                          quicr::SubscribeIntent::sync_up,
+                          "",
+                          transportMode,
+                          "",
+                          e2eToken,
+                          profileFragmentSize(layers[initial]) > 0)
+        != 0)
+    {
+        return;
+    }
+
+    const auto delegate = findQuicrSubscriptionDelegate(layers[initial].quicrNamespace);
+    if (delegate) setProfileDeadline(*delegate, layers[initial]);
+
+    std::lock_guard<std::mutex> _(layersMutex);
+    layerSets.erase(sourceId);
+    layerSets.emplace(sourceId,
+                      LayerSet{
+                          .qDelegate = std::move(qDelegate),
+                          .transportMode = transportMode,
+                          .layers = std::move(layers),
+                          .adaptation = LayerAdaptation(*adaptation_config,
+                                                        std::move(bitrates),
+                                                        initial,
+                                                        std::chrono::steady_clock::now()),
+                          .pending = std::nullopt,
+                          .pending_since = {},
+                          .last = delegate ? delegate->getStats() : SubscriptionStats{},
+                      });
+}
+
+PublicationStats QController::getPublicationStats(const quicr::Namespace& quicrNamespace)
+{
+    const auto handle = getPublicationHandle(quicrNamespace);
+    if (!handle.delegate) return {};
+
+    return handle.delegate->getStats();
+}
+
+PublicationHandle QController::getPublicationHandle(const quicr::Namespace& quicrNamespace)
 {
     const std::lock_guard<std::mutex> _(pubsMutex);
     const auto& it = quicrPublicationsMap.find(quicrNamespace);
     if (it == quicrPublicationsMap.end())
     {
         LOGGER_WARN(logger, "Publication not found for {0}", std::string(quicrNamespace));
-        return;
+        return {};
     }
-    const auto& publication = it->second;
-    if (publication.state != PublicationState::paused)
+    return PublicationHandle(it->second);
+}
+
+void QController::publishNamedObject(const PublicationHandle& handle,
+                                     std::span<const std::uint8_t> data,
+                                     bool groupFlag)
+{
+    if (!handle.delegate) return;
+    handle.delegate->publishNamedObject(client_session, data, groupFlag, startTrace());
+}
+
+void QController::publishNamedObject(const PublicationHandle& handle, quicr::bytes&& data, bool groupFlag)
+{
+    if (!handle.delegate) return;
+    handle.delegate->publishNamedObject(client_session, std::move(data), groupFlag, startTrace());
+}
+
+void QController::publishNamedObject(const PublicationHandle& handle, ObjectBuffer&& data, bool groupFlag)
+{
+    if (!handle.delegate) return;
+    handle.delegate->publishNamedObject(client_session, std::move(data), groupFlag, startTrace());
+}
+
+ObjectBuffer QController::allocateObjectBuffer(const PublicationHandle& handle, std::size_t size)
+{
+    if (!handle.delegate) return ObjectBuffer(0, size, 0);
+    return handle.delegate->allocateObjectBuffer(size);
+}
+
+void QController::publishNamedObjects(std::span<PublishObject> objects)
+{
+    auto trace = startTrace();
+
+    auto run_begin = objects.begin();
+    while (run_begin != objects.end())
     {
-        const auto start_time = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now());
+        // Group consecutive objects for the same publication
+        const auto& delegate = run_begin->handle.delegate;
+        const auto run_end = std::find_if(run_begin, objects.end(), [&delegate](const PublishObject& object) {
+            return object.handle.delegate != delegate;
+        });
 
-        std::vector<qtransport::MethodTraceItem> trace;
-        trace.reserve(10);
-        trace.push_back({"qController:publishNamedObject", start_time});
+        if (delegate)
+        {
+            delegate->publishNamedObjects(client_session,
+                                          std::span<PublishObject>(run_begin, run_end),
+                                          std::exchange(trace, trace.untraced()));
+        }
 
-        publication.delegate->publishNamedObject(this->client_session, data, len, groupFlag, std::move(trace));
+        run_begin = run_end;
     }
 }
 
@@ -152,18 +603,14 @@ void QController::publishNamedObject(const quicr::Namespace& quicrNamespace,
  */
 void QController::publishNamedObjectTest(std::uint8_t* data, std::size_t len, bool groupFlag)
 {
-    const std::lock_guard<std::mutex> _(pubsMutex);
-    if (quicrPublicationsMap.empty()) return;
-
-    const auto& publication = quicrPublicationsMap.begin()->second;
-    if (publication.state != PublicationState::paused)
+    std::shared_ptr<PublicationDelegate> delegate;
     {
-        const auto start_time = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now());
-
-        std::vector<qtransport::MethodTraceItem> trace;
-        trace.push_back({"qController:publishNamedObject", start_time});
-        publication.delegate->publishNamedObject(this->client_session, data, len, groupFlag, std::move(trace));
+        const std::lock_guard<std::mutex> _(pubsMutex);
+        if (quicrPublicationsMap.empty()) return;
+        delegate = quicrPublicationsMap.begin()->second;
     }
+
+    delegate->publishNamedObject(this->client_session, data, len, groupFlag, startTrace());
 }
 
 /*===========================================================================*/
@@ -189,7 +636,7 @@ QController::createQuicrSubscriptionDelegate(const std::string& sourceId,
                                              const std::string& authToken,
                                              quicr::bytes&& e2eToken,
                                              std::shared_ptr<qmedia::QSubscriptionDelegate> qDelegate,
-                                             const std::optional<sframe::CipherSuite> cipherSuite)
+                                             bool fragmented)
 {
     std::lock_guard<std::mutex> _(subsMutex);
     if (quicrSubscriptionsMap.contains(quicrNamespace))
@@ -207,7 +654,17 @@ QController::createQuicrSubscriptionDelegate(const std::string& sourceId,
                                                                          std::move(e2eToken),
                                                                          std::move(qDelegate),
                                                                          logger,
-                                                                         cipherSuite);
+                                                                         sframe_context,
+                                                                         buffer_pool);
+
+    if (fragmented) quicrSubscriptionsMap[quicrNamespace]->enableFragmentation();
+    if (reorder_config && transportMode != quicr::TransportMode::ReliablePerTrack)
+    {
+        quicrSubscriptionsMap[quicrNamespace]->enableReorderBuffer(*reorder_config);
+    }
+    if (delivery_executor) delivery_executor->attach(quicrSubscriptionsMap[quicrNamespace]);
+    if (sframe_context) warmKeys([delegate = quicrSubscriptionsMap[quicrNamespace]] { delegate->prepareKeys(); });
+
     return quicrSubscriptionsMap[quicrNamespace];
 }
 
@@ -216,7 +673,7 @@ std::shared_ptr<PublicationDelegate> QController::findQuicrPublicationDelegate(c
     std::lock_guard<std::mutex> _(pubsMutex);
     if (quicrPublicationsMap.contains(quicrNamespace))
     {
-        return quicrPublicationsMap[quicrNamespace].delegate->getptr();
+        return quicrPublicationsMap[quicrNamespace]->getptr();
     }
     return nullptr;
 }
@@ -230,7 +687,8 @@ QController::createQuicrPublicationDelegate(std::shared_ptr<qmedia::QPublication
                                             quicr::bytes&& payload,
                                             const std::vector<std::uint8_t>& priority,
                                             const std::vector<std::uint16_t>& expiry,
-                                            const quicr::TransportMode transportMode)
+                                            const quicr::TransportMode transportMode,
+                                            std::size_t fragmentSize)
 {
     std::lock_guard<std::mutex> _(pubsMutex);
     if (quicrPublicationsMap.contains(quicrNamespace))
@@ -239,22 +697,207 @@ QController::createQuicrPublicationDelegate(std::shared_ptr<qmedia::QPublication
         return nullptr;
     }
 
-    quicrPublicationsMap[quicrNamespace] = {
-        .state = PublicationState::active,
-        .delegate = PublicationDelegate::create(std::move(qDelegate),
-                                                sourceId,
-                                                quicrNamespace,
-                                                transportMode,
-                                                originUrl,
-                                                authToken,
-                                                std::move(payload),
-                                                priority,
-                                                expiry,
-                                                logger,
-                                                cipher_suite)
-    };
+    quicrPublicationsMap[quicrNamespace] = PublicationDelegate::create(std::move(qDelegate),
+                                                                       sourceId,
+                                                                       quicrNamespace,
+                                                                       transportMode,
+                                                                       originUrl,
+                                                                       authToken,
+                                                                       std::move(payload),
+                                                                       priority,
+                                                                       expiry,
+                                                                       logger,
+                                                                       sframe_context,
+                                                                       buffer_pool);
+
+    if (fragmentSize) quicrPublicationsMap[quicrNamespace]->enableFragmentation(fragmentSize);
+    if (publish_pipeline) publish_pipeline->attach(quicrPublicationsMap[quicrNamespace]);
+    if (sframe_context) warmKeys([delegate = quicrPublicationsMap[quicrNamespace]] { delegate->prepareKeys(); });
+
+    return quicrPublicationsMap[quicrNamespace]->getptr();
+}
 
-    return quicrPublicationsMap[quicrNamespace].delegate->getptr();
+void QController::warmKeys(std::function<void()> prepare)
+{
+    {
+        std::lock_guard<std::mutex> _(warmupsMutex);
+        key_warmups.push_back(std::move(prepare));
+        if (!warmup_thread.joinable()) warmup_thread = std::thread(&QController::runKeyWarmups, this);
+    }
+    warmups_cv.notify_one();
+}
+
+void QController::runKeyWarmups()
+{
+    std::unique_lock<std::mutex> lock(warmupsMutex);
+    while (true)
+    {
+        warmups_cv.wait(lock, [this] { return warmups_stop || !key_warmups.empty(); });
+
+        // Warm-ups still queued when stopping are dropped, keys derive on use.
+        if (warmups_stop) return;
+
+        auto prepare = std::move(key_warmups.front());
+        key_warmups.pop_front();
+        warmup_running = true;
+
+        lock.unlock();
+        try
+        {
+            prepare();
+        }
+        catch (const std::exception& e)
+        {
+            LOGGER_ERROR(logger, "Exception trying to derive keys: {0}", e.what());
+        }
+        catch (...)
+        {
+            LOGGER_ERROR(logger, "Unknown error trying to derive keys");
+        }
+        lock.lock();
+
+        warmup_running = false;
+        warmups_cv.notify_all();
+    }
+}
+
+void QController::awaitKeyWarmups()
+{
+    std::unique_lock<std::mutex> lock(warmupsMutex);
+    warmups_cv.wait(lock, [this] { return warmups_stop || (key_warmups.empty() && !warmup_running); });
+}
+
+void QController::installEpoch(std::uint64_t epoch, const quicr::bytes& secret)
+{
+    if (!sframe_context)
+    {
+        LOGGER_WARN(logger, "Ignoring epoch {0}, objects are not encrypted", epoch);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> _(epochsMutex);
+        current_epoch = epoch;
+        pending_epochs[epoch] = secret;
+        retiring_epochs.erase(epoch);
+    }
+
+    LOGGER_INFO(logger, "Installing epoch {0}", epoch);
+    warmKeys([this, epoch] { enableInstalledEpoch(epoch); });
+}
+
+void QController::enableInstalledEpoch(std::uint64_t epoch)
+{
+    std::unique_lock<std::mutex> update(epochUpdateMutex);
+
+    auto secret = quicr::bytes();
+    {
+        std::lock_guard<std::mutex> _(epochsMutex);
+        const auto pending = pending_epochs.find(epoch);
+
+        // Installed more than once: an earlier warm-up took the latest secret.
+        if (pending == pending_epochs.end()) return;
+
+        secret = std::move(pending->second);
+        pending_epochs.erase(pending);
+    }
+
+    // Derives the epoch's keys for every namespace in use, once each.
+    sframe_context->addEpoch(epoch, secret);
+
+    {
+        std::lock_guard<std::mutex> _(epochsMutex);
+
+        // The overlap starts once publications stop encrypting with an
+        // epoch, not when its replacement was installed.
+        const auto deadline = std::chrono::steady_clock::now() + epoch_overlap;
+        if (current_epoch == epoch)
+        {
+            sframe_context->enableEpoch(epoch);
+            if (enabled_epoch != epoch) retiring_epochs[enabled_epoch] = deadline;
+            enabled_epoch = epoch;
+        }
+        else
+        {
+            // Superseded while it was derived; peers may still have switched to it.
+            retiring_epochs[epoch] = deadline;
+        }
+
+        if (!epoch_thread.joinable()) epoch_thread = std::thread(&QController::runEpochRetirement, this);
+    }
+    update.unlock();
+
+    // The retirement thread holds periodic_mutex while it looks for the next
+    // deadline, so this notification can't slip in before it waits.
+    {
+        std::lock_guard<std::mutex> _(periodic_mutex);
+    }
+    periodic_cv.notify_all();
+}
+
+void QController::setEpochOverlap(std::chrono::milliseconds overlap)
+{
+    std::lock_guard<std::mutex> _(epochsMutex);
+    epoch_overlap = overlap;
+}
+
+void QController::runEpochRetirement()
+{
+    auto retired = std::vector<std::uint64_t>();
+
+    std::unique_lock<std::mutex> lock(periodic_mutex);
+    while (!periodic_stop)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        auto next = std::chrono::steady_clock::time_point::max();
+        {
+            std::lock_guard<std::mutex> _(epochsMutex);
+            for (auto it = retiring_epochs.begin(); it != retiring_epochs.end();)
+            {
+                if (it->second > now)
+                {
+                    next = std::min(next, it->second);
+                    ++it;
+                    continue;
+                }
+
+                retired.push_back(it->first);
+                it = retiring_epochs.erase(it);
+            }
+        }
+
+        if (retired.empty())
+        {
+            // Nothing retiring: sleep until an epoch is installed or stopping.
+            if (next == std::chrono::steady_clock::time_point::max())
+            {
+                periodic_cv.wait(lock);
+            }
+            else
+            {
+                periodic_cv.wait_until(lock, next);
+            }
+            continue;
+        }
+
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> _(epochUpdateMutex);
+            for (const auto epoch : retired)
+            {
+                // Enabled or rescheduled again since its deadline was found.
+                {
+                    std::lock_guard<std::mutex> lock(epochsMutex);
+                    if (epoch == enabled_epoch || retiring_epochs.contains(epoch)) continue;
+                }
+
+                LOGGER_INFO(logger, "Evicting epoch {0}", epoch);
+                sframe_context->removeEpoch(epoch);
+            }
+        }
+        retired.clear();
+        lock.lock();
+    }
 }
 
 /*===========================================================================*/
@@ -307,7 +950,8 @@ int QController::startSubscription(std::shared_ptr<qmedia::QSubscriptionDelegate
                                    const std::string& originUrl,
                                    const quicr::TransportMode transportMode,
                                    const std::string& authToken,
-                                   quicr::bytes& e2eToken)
+                                   quicr::bytes& e2eToken,
+                                   bool fragmented)
 {
     // look to see if we already have a quicr delegate
     auto sub_delegate = findQuicrSubscriptionDelegate(quicrNamespace);
@@ -321,7 +965,7 @@ int QController::startSubscription(std::shared_ptr<qmedia::QSubscriptionDelegate
                                                        authToken,
                                                        std::move(e2eToken),
                                                        std::move(qDelegate),
-                                                       cipher_suite);
+                                                       fragmented);
     }
 
     if (!sub_delegate)
@@ -359,7 +1003,8 @@ int QController::startPublication(std::shared_ptr<qmedia::QPublicationDelegate>
                                   quicr::bytes&& payload,
                                   const std::vector<std::uint8_t>& priority,
                                   const std::vector<std::uint16_t>& expiry,
-                                  const quicr::TransportMode transportMode)
+                                  const quicr::TransportMode transportMode,
+                                  std::size_t fragmentSize)
 
 {
     if (!client_session)
@@ -376,7 +1021,8 @@ int QController::startPublication(std::shared_ptr<qmedia::QPublicationDelegate>
                                                            std::move(payload),
                                                            priority,
                                                            expiry,
-                                                           transportMode);
+                                                           transportMode,
+                                                           fragmentSize);
     if (!quicrPubDelegate)
     {
         LOGGER_ERROR(logger, "Failed to start publication for {0}: Delegate was null", std::string(quicrNamespace));
@@ -388,6 +1034,36 @@ int QController::startPublication(std::shared_ptr<qmedia::QPublicationDelegate>
     return 0;
 }
 
+void QController::stopPublication(const quicr::Namespace& quicrNamespace)
+{
+    std::shared_ptr<PublicationDelegate> pub_delegate;
+    {
+        std::lock_guard<std::mutex> _(pubsMutex);
+        const auto& it = quicrPublicationsMap.find(quicrNamespace);
+        if (it == quicrPublicationsMap.end())
+        {
+            LOGGER_WARN(logger, "Publication not found for {0}", std::string(quicrNamespace));
+            return;
+        }
+        pub_delegate = it->second;
+        quicrPublicationsMap.erase(it);
+    }
+
+    // Outstanding handles see the publication as invalid from here on.
+    pub_delegate->invalidate();
+    pub_delegate->publishIntentEnd(client_session);
+
+    {
+        std::lock_guard<std::mutex> _(qPubsMutex);
+        if (qPublicationsMap.erase(std::string(quicrNamespace)) > 0 && qPublisherDelegate)
+        {
+            qPublisherDelegate->removePubByNamespace(quicrNamespace);
+        }
+    }
+
+    LOGGER_INFO(logger, "Stopped publication {0}", std::string(quicrNamespace));
+}
+
 void QController::processSubscriptions(const std::vector<manifest::MediaStream>& subscriptions)
 {
     LOGGER_DEBUG(logger, "Processing subscriptions...");
@@ -415,6 +1091,12 @@ void QController::processSubscriptions(const std::vector<manifest::MediaStream>&
             continue;
         }
 
+        if (adaptation_config && is_singleordered_subscription && subscription.profileSet.profiles.size() > 1)
+        {
+            startAdaptiveSubscription(delegate, subscription.sourceId, subscription.profileSet, transportMode);
+            continue;
+        }
+
         for (const auto& profile : subscription.profileSet.profiles)
         {
             quicr::bytes e2eToken;
@@ -425,7 +1107,11 @@ void QController::processSubscriptions(const std::vector<manifest::MediaStream>&
                               "",
                               transportMode,
                               "",
-                              e2eToken);
+                              e2eToken,
+                              profileFragmentSize(profile) > 0);
+
+            const auto quicrSubDelegate = findQuicrSubscriptionDelegate(profile.quicrNamespace);
+            if (quicrSubDelegate) setProfileDeadline(*quicrSubDelegate, profile);
 
                 // If singleordered, and we've successfully processed 1 delegate, break.
                 if (is_singleordered_subscription) break;
@@ -438,6 +1124,31 @@ void QController::processSubscriptions(const std::vector<manifest::MediaStream>&
 void QController::processPublications(const std::vector<manifest::MediaStream>& publications)
 {
     LOGGER_DEBUG(logger, "Processing publications...");
+
+    // Publications that are no longer in the manifest are stopped.
+    std::set<quicr::Namespace> manifest_namespaces;
+    for (const auto& publication : publications)
+    {
+        for (const auto& profile : publication.profileSet.profiles)
+        {
+            manifest_namespaces.insert(profile.quicrNamespace);
+        }
+    }
+
+    std::vector<quicr::Namespace> removed;
+    {
+        std::lock_guard<std::mutex> _(pubsMutex);
+        for (const auto& [quicrNamespace, delegate] : quicrPublicationsMap)
+        {
+            if (!manifest_namespaces.contains(quicrNamespace)) removed.push_back(quicrNamespace);
+        }
+    }
+
+    for (const auto& quicrNamespace : removed)
+    {
+        stopPublication(quicrNamespace);
+    }
+
     for (auto& publication : publications)
     {
         for (auto& profile : publication.profileSet.profiles)
@@ -463,15 +1174,27 @@ void QController::processPublications(const std::vector<manifest::MediaStream>&
             }
 
             quicr::bytes payload;
-            startPublication(delegate,
-                             publication.sourceId,
-                             profile.quicrNamespace,
-                             "",
-                             "",
-                             std::move(payload),
-                             profile.priorities,
-                             profile.expiry,
-                             transportMode);
+            const auto started = startPublication(delegate,
+                                                  publication.sourceId,
+                                                  profile.quicrNamespace,
+                                                  "",
+                                                  "",
+                                                  std::move(payload),
+                                                  profile.priorities,
+                                                  profile.expiry,
+                                                  transportMode,
+                                                  profileFragmentSize(profile));
+
+            if (started == 0 && paced_sender)
+            {
+                const auto quality = manifest::QualityProfile::parse(profile.qualityProfile);
+                const auto is_audio = publication.mediaType == "audio" || quality.codec == "opus";
+                const auto quicrPubDelegate = findQuicrPublicationDelegate(profile.quicrNamespace);
+                if (quicrPubDelegate && (!is_audio || pacer_config.pace_audio))
+                {
+                    quicrPubDelegate->enablePacing(paced_sender, quality.bitrate, pacer_config);
+                }
+            }
 
             // If singleordered, and we've successfully processed 1 delegate, break.
             if (is_singleordered_publication) break;
@@ -529,7 +1252,7 @@ std::vector<QController::PublicationReport> QController::getPublications()
     std::vector<PublicationReport> publications;
     for (const auto& publication : quicrPublicationsMap) {
         publications.push_back({
-            .state = publication.second.state,
+            .state = publication.second->isPaused() ? PublicationState::paused : PublicationState::active,
             .quicrNamespace = publication.first,
         });
     }
@@ -545,7 +1268,7 @@ void QController::setPublicationState(const quicr::Namespace& quicrNamespace, co
         LOGGER_WARN(logger, "Publication not found for {0}", std::string(quicrNamespace));
         return;
     }
-    it->second.state = state;
+    it->second->setPaused(state == PublicationState::paused);
 }
 
 void QController::setSubscriptionState(const quicr::Namespace& quicrNamespace, const quicr::TransportMode transportMode)
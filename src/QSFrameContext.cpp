@@ -2,32 +2,130 @@
 #include "qmedia/QSFrameContext.hpp"
 #include "sframe/crypto.h"
 
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+constexpr std::size_t Initial_Context_Slots = 16;
+
+// Threads take reader stripes in turn, the first time they read.
+std::size_t reader_stripe(std::size_t stripes)
+{
+    static std::atomic<std::size_t> next_stripe = 0;
+    thread_local const std::size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed);
+    return stripe % stripes;
+}
+}
+
 namespace qmedia
 {
 QSFrameContext::QSFrameContext(sframe::CipherSuite cipher_suite) : cipher_suite(cipher_suite)
 {
-    // Nothing more to do
+    auto keys = std::make_unique<KeySet>();
+    keys->contexts.resize(Initial_Context_Slots);
+    key_set = keys.release();
 }
 
 QSFrameContext::QSFrameContext(QSFrameContext& other)
 {
-    std::lock_guard<std::mutex> lock(other.context_mutex);
+    // Installed contexts are never modified, so the copy can share them.
+    std::lock_guard<std::mutex> lock(other.update_mutex);
     cipher_suite = other.cipher_suite;
-    current_epoch = other.current_epoch;
-    epoch_secrets = other.epoch_secrets;
-    ns_contexts = other.ns_contexts;
+    key_set = other.copy_keys().release();
+}
+
+QSFrameContext::~QSFrameContext()
+{
+    delete key_set.load();
 }
 
 void QSFrameContext::addEpoch(uint64_t epoch_id, const quicr::bytes& epoch_secret)
 {
-    std::lock_guard<std::mutex> lock(context_mutex);
-    epoch_secrets[epoch_id] = epoch_secret;
+    auto keys = std::vector<ContextKey>();
+    {
+        std::lock_guard<std::mutex> lock(update_mutex);
+        auto next = copy_keys();
+        const auto previous = next->epoch_secrets.find(epoch_id);
+        if (previous != next->epoch_secrets.end() && previous->second != epoch_secret) next->erase_epoch(epoch_id);
+        next->epoch_secrets[epoch_id] = epoch_secret;
+
+        // Namespaces in use will want the new epoch's keys too.
+        for (const auto& entry : next->contexts)
+        {
+            const auto key = ContextKey{entry.key.quicr_namespace, epoch_id};
+            if (entry.context && std::find(keys.begin(), keys.end(), key) == keys.end()) keys.push_back(key);
+        }
+        publish(std::move(next));
+    }
+
+    install_keys(keys, true);
 }
 
 void QSFrameContext::enableEpoch(uint64_t epoch_id)
 {
-    std::lock_guard<std::mutex> lock(context_mutex);
-    current_epoch = epoch_id;
+    std::lock_guard<std::mutex> lock(update_mutex);
+    auto next = copy_keys();
+    next->current_epoch = epoch_id;
+    publish(std::move(next));
+}
+
+void QSFrameContext::removeEpoch(uint64_t epoch_id)
+{
+    std::lock_guard<std::mutex> lock(update_mutex);
+    auto next = copy_keys();
+    if (!next->epoch_secrets.erase(epoch_id)) return;
+
+    next->erase_epoch(epoch_id);
+    if (next->current_epoch == epoch_id) next->current_epoch.reset();
+    publish(std::move(next));
+}
+
+std::optional<uint64_t> QSFrameContext::currentEpoch() const
+{
+    const auto section = ReadSection(*this);
+    return section.keys().current_epoch;
+}
+
+std::size_t QSFrameContext::getKeyCount() const
+{
+    const auto section = ReadSection(*this);
+    return section.keys().context_count;
+}
+
+void QSFrameContext::prepareKeys(const quicr::Namespace& quicr_namespace)
+{
+    auto keys = std::vector<ContextKey>();
+    {
+        const auto section = ReadSection(*this);
+        for (const auto& [epoch_id, secret] : section.keys().epoch_secrets)
+        {
+            keys.push_back({quicr_namespace, epoch_id});
+        }
+    }
+
+    install_keys(keys);
+}
+
+void QSFrameContext::retainNamespace(const quicr::Namespace& quicr_namespace)
+{
+    std::lock_guard<std::mutex> lock(update_mutex);
+    ++namespace_users[quicr_namespace];
+}
+
+void QSFrameContext::releaseNamespace(const quicr::Namespace& quicr_namespace)
+{
+    std::lock_guard<std::mutex> lock(update_mutex);
+    const auto users = namespace_users.find(quicr_namespace);
+    if (users == namespace_users.end() || --users->second > 0) return;
+
+    namespace_users.erase(users);
+    auto next = copy_keys();
+    next->erase_namespace(quicr_namespace);
+    publish(std::move(next));
 }
 
 sframe::output_bytes QSFrameContext::protect(const quicr::Namespace& quicr_namespace,
@@ -35,10 +133,51 @@ sframe::output_bytes QSFrameContext::protect(const quicr::Namespace& quicr_names
                                              sframe::output_bytes ciphertext,
                                              const sframe::input_bytes plaintext)
 {
-    std::lock_guard<std::mutex> lock(context_mutex);
-    if (!current_epoch.has_value()) return {};
-    ensure_key(*current_epoch, quicr_namespace);
-    return ns_contexts.at(quicr_namespace).protect(sframe::Header(*current_epoch, ctr), ciphertext, plaintext);
+    const auto epoch = currentEpoch();
+    if (!epoch.has_value()) return {};
+
+    return protect(*epoch, quicr_namespace, ctr, ciphertext, plaintext);
+}
+
+sframe::output_bytes QSFrameContext::protect(const quicr::Namespace& quicr_namespace,
+                                             sframe::Counter ctr,
+                                             sframe::output_bytes buffer,
+                                             std::size_t plaintext_size)
+{
+    // AEAD ciphertext starts where the plaintext does, so the two views may alias.
+    const auto plaintext = sframe::input_bytes(buffer.data(), plaintext_size);
+    return protect(quicr_namespace, ctr, buffer, plaintext);
+}
+
+sframe::output_bytes QSFrameContext::protect(uint64_t epoch,
+                                             const quicr::Namespace& quicr_namespace,
+                                             sframe::Counter ctr,
+                                             sframe::output_bytes ciphertext,
+                                             const sframe::input_bytes plaintext)
+{
+    for (;;)
+    {
+        {
+            const auto section = ReadSection(*this);
+            if (auto* context = section.keys().find({quicr_namespace, epoch}))
+            {
+                return context->protect(sframe::Header(epoch, ctr), ciphertext, plaintext);
+            }
+        }
+
+        // Not prepared ahead, derive it on the media path.
+        install_key(epoch, quicr_namespace);
+    }
+}
+
+sframe::output_bytes QSFrameContext::protect(uint64_t epoch,
+                                             const quicr::Namespace& quicr_namespace,
+                                             sframe::Counter ctr,
+                                             sframe::output_bytes buffer,
+                                             std::size_t plaintext_size)
+{
+    const auto plaintext = sframe::input_bytes(buffer.data(), plaintext_size);
+    return protect(epoch, quicr_namespace, ctr, buffer, plaintext);
 }
 
 sframe::output_bytes QSFrameContext::unprotect(uint64_t epoch,
@@ -47,35 +186,210 @@ sframe::output_bytes QSFrameContext::unprotect(uint64_t epoch,
                                                sframe::output_bytes plaintext,
                                                const sframe::input_bytes ciphertext)
 {
-    std::lock_guard<std::mutex> lock(context_mutex);
-    ensure_key(epoch, quicr_namespace);
-    return ns_contexts.at(quicr_namespace).unprotect(sframe::Header(epoch, ctr), plaintext, ciphertext);
+    for (;;)
+    {
+        {
+            const auto section = ReadSection(*this);
+            if (auto* context = section.keys().find({quicr_namespace, epoch}))
+            {
+                return context->unprotect(sframe::Header(epoch, ctr), plaintext, ciphertext);
+            }
+        }
+
+        install_key(epoch, quicr_namespace);
+    }
 }
 
-void QSFrameContext::ensure_key(uint64_t epoch_id, const quicr::Namespace& quicr_namespace)
+sframe::output_bytes QSFrameContext::unprotect(uint64_t epoch,
+                                               const quicr::Namespace& quicr_namespace,
+                                               sframe::Counter ctr,
+                                               sframe::output_bytes buffer)
+{
+    // As for protect, AEAD plaintext starts where the ciphertext does.
+    const auto ciphertext = sframe::input_bytes(buffer.data(), buffer.size());
+    return unprotect(epoch, quicr_namespace, ctr, buffer, ciphertext);
+}
+
+QSFrameContext::ReadSection::ReadSection(const QSFrameContext& context) :
+    context(context), phase(context.reader_phase.load()), stripe(reader_stripe(Reader_Stripes))
+{
+    // Counted before loading, so a writer that swaps the snapshot after this
+    // point waits for this section before freeing the one loaded here.
+    context.readers[phase][stripe].count.fetch_add(1);
+    key_set = context.key_set.load();
+}
+
+QSFrameContext::ReadSection::~ReadSection()
+{
+    context.readers[phase][stripe].count.fetch_sub(1);
+}
+
+void QSFrameContext::install_key(uint64_t epoch_id, const quicr::Namespace& quicr_namespace)
+{
+    // On the media path: count it, it should have been prepared.
+    cold_key_misses.fetch_add(1, std::memory_order_relaxed);
+    install_keys({{quicr_namespace, epoch_id}});
+
+    const auto section = ReadSection(*this);
+    if (!section.keys().find({quicr_namespace, epoch_id}))
+    {
+        throw std::runtime_error("No secret for epoch " + std::to_string(epoch_id));
+    }
+}
+
+void QSFrameContext::install_keys(const std::vector<ContextKey>& keys, bool in_use_only)
+{
+    auto missing = std::vector<std::pair<ContextKey, quicr::bytes>>();
+    {
+        const auto section = ReadSection(*this);
+        for (const auto& key : keys)
+        {
+            if (section.keys().find(key)) continue;
+
+            const auto secret = section.keys().epoch_secrets.find(key.epoch_id);
+            if (secret != section.keys().epoch_secrets.end()) missing.emplace_back(key, secret->second);
+        }
+    }
+    if (missing.empty()) return;
+
+    // Readers and other writers carry on while the keys are derived.
+    auto derived = std::vector<ContextSlot>();
+    for (const auto& [key, secret] : missing)
+    {
+        auto context = std::make_shared<sframe::ContextBase>(cipher_suite);
+        context->add_key(key.epoch_id, derive_base_key(secret, key.quicr_namespace));
+        derived.push_back({key, std::move(context)});
+    }
+
+    // Whatever another thread installed meanwhile is kept.
+    std::lock_guard<std::mutex> lock(update_mutex);
+    auto next = copy_keys();
+
+    // A namespace released meanwhile has no keys left, nor users.
+    auto in_use = std::vector<quicr::Namespace>();
+    if (in_use_only)
+    {
+        for (const auto& entry : next->contexts)
+        {
+            if (entry.context) in_use.push_back(entry.key.quicr_namespace);
+        }
+    }
+
+    for (std::size_t i = 0; i < derived.size(); ++i)
+    {
+        const auto& key = derived[i].key;
+        const auto secret = next->epoch_secrets.find(key.epoch_id);
+        if (secret == next->epoch_secrets.end() || secret->second != missing[i].second) continue;
+        if (in_use_only && !namespace_users.contains(key.quicr_namespace)
+            && std::find(in_use.begin(), in_use.end(), key.quicr_namespace) == in_use.end())
+        {
+            continue;
+        }
+
+        if (!next->find(key)) next->insert(key, std::move(derived[i].context));
+    }
+    publish(std::move(next));
+}
+
+std::unique_ptr<QSFrameContext::KeySet> QSFrameContext::copy_keys() const
+{
+    // NOTE: caller must lock update_mutex, which keeps the snapshot from changing
+    return std::make_unique<KeySet>(*key_set.load());
+}
+
+void QSFrameContext::publish(std::unique_ptr<KeySet> next)
 {
-    // NOTE: caller must lock the mutex
+    // NOTE: caller must lock update_mutex
+
+    const auto* previous = key_set.exchange(next.release());
+
+    // A reader may have read the phase just before a flip and be counted in
+    // either one, so both are drained after the swap before freeing.
+    for (int flip = 0; flip < 2; ++flip)
+    {
+        const auto phase = reader_phase.fetch_xor(1);
+        for (const auto& reader : readers[phase])
+        {
+            while (reader.count.load() != 0) std::this_thread::yield();
+        }
+    }
+
+    delete previous;
+}
+
+sframe::ContextBase* QSFrameContext::KeySet::find(const ContextKey& key) const
+{
+    const auto mask = contexts.size() - 1;
+    for (auto slot = hash(key) & mask;; slot = (slot + 1) & mask)
+    {
+        const auto& entry = contexts[slot];
+        if (!entry.context) return nullptr;
+        if (entry.key == key) return entry.context.get();
+    }
+}
 
-    if ((ns_contexts.count(quicr_namespace) > 0) && !ns_contexts.at(quicr_namespace).has_key(epoch_id))
+void QSFrameContext::KeySet::insert(const ContextKey& key, std::shared_ptr<sframe::ContextBase> context)
+{
+    if ((context_count + 1) * 2 > contexts.size())
     {
-        return;
+        auto previous = std::vector<ContextSlot>(contexts.size() * 2);
+        previous.swap(contexts);
+        context_count = 0;
+        for (auto& entry : previous)
+        {
+            if (entry.context) insert(entry.key, std::move(entry.context));
+        }
     }
 
-    if (ns_contexts.count(quicr_namespace) == 0)
+    const auto mask = contexts.size() - 1;
+    auto slot = hash(key) & mask;
+    while (contexts[slot].context) slot = (slot + 1) & mask;
+
+    contexts[slot] = {key, std::move(context)};
+    ++context_count;
+}
+
+template<typename Predicate>
+void QSFrameContext::KeySet::erase_if(Predicate erased)
+{
+    // Probe chains can't have holes, so the others are inserted afresh.
+    auto previous = std::vector<ContextSlot>(contexts.size());
+    previous.swap(contexts);
+    context_count = 0;
+    for (auto& entry : previous)
     {
-        ns_contexts.emplace(quicr_namespace, sframe::ContextBase(cipher_suite));
+        if (entry.context && !erased(entry.key)) insert(entry.key, std::move(entry.context));
     }
+}
 
-    const auto base_key = derive_base_key(epoch_id, quicr_namespace);
-    ns_contexts.at(quicr_namespace).add_key(epoch_id, base_key);
+void QSFrameContext::KeySet::erase_epoch(uint64_t epoch_id)
+{
+    erase_if([epoch_id](const ContextKey& key) { return key.epoch_id == epoch_id; });
+}
+
+void QSFrameContext::KeySet::erase_namespace(const quicr::Namespace& quicr_namespace)
+{
+    erase_if([&quicr_namespace](const ContextKey& key) { return key.quicr_namespace == quicr_namespace; });
+}
+
+std::uint64_t QSFrameContext::hash(const ContextKey& key)
+{
+    // splitmix64 finalizer over the namespace bits, length and epoch.
+    const auto name = key.quicr_namespace.name();
+    auto value = name.bits<std::uint64_t>(0, 64);
+    value ^= std::rotl(name.bits<std::uint64_t>(64, 64), 29);
+    value ^= std::rotl(key.epoch_id, 47) ^ key.quicr_namespace.length();
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
 }
 
-sframe::bytes QSFrameContext::derive_base_key(uint64_t epoch_id, const quicr::Namespace& quicr_namespace)
+sframe::bytes QSFrameContext::derive_base_key(const quicr::bytes& epoch_secret,
+                                              const quicr::Namespace& quicr_namespace) const
 {
-    // NOTE: caller must lock the mutex
     std::string salt_string = "Quicr epoch base key " + std::string(quicr_namespace);
     sframe::bytes salt(salt_string.begin(), salt_string.end());
-    return sframe::hkdf_extract(cipher_suite, salt, epoch_secrets[epoch_id]);
+    return sframe::hkdf_extract(cipher_suite, salt, epoch_secret);
 }
 
 }        // namespace qmedia
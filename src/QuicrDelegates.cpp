@@ -3,10 +3,14 @@
 
 #include <quicr/hex_endec.h>
 #include <quicr/message_buffer.h>
-#include <sframe/crypto.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <thread>
+#include <utility>
 #include <ctime>
 
 #define LOGGER_TRACE(logger, ...) if (logger) SPDLOG_LOGGER_TRACE(logger, __VA_ARGS__)
@@ -19,11 +23,56 @@
 constexpr quicr::Name Group_ID_Mask = ~(~0x0_name << 32) << 16;
 constexpr quicr::Name Object_ID_Mask = ~(~0x0_name << 16);
 
-constexpr uint64_t Fixed_Epoch = 1;
 constexpr uint8_t Quicr_SFrame_Sig_Bits = 80;
 
+// Objects a pipeline task sends before yielding to other publications.
+constexpr std::size_t Max_Drain_Batch = 32;
+
+namespace
+{
+quicr::bytes encodeEpoch(std::uint64_t epoch)
+{
+    auto buf = quicr::messages::MessageBuffer();
+    buf << quicr::uintVar_t(epoch);
+    return buf.take();
+}
+}        // namespace
+
 namespace qmedia
 {
+SubscriptionStats& SubscriptionStats::operator+=(const SubscriptionStats& other)
+{
+    objects += other.objects;
+    bytes += other.bytes;
+    decrypt_failures += other.decrypt_failures;
+    expired += other.expired;
+    duplicates += other.duplicates;
+    inter_arrival += other.inter_arrival;
+    object_size += other.object_size;
+
+    fragments.reassembled += other.fragments.reassembled;
+    fragments.abandoned += other.fragments.abandoned;
+
+    loss.groups += other.loss.groups;
+    loss.lost_objects += other.loss.lost_objects;
+    loss.lost_groups += other.loss.lost_groups;
+    loss.reordered += other.loss.reordered;
+    loss.recovered += other.loss.recovered;
+    loss.incomplete_groups += other.loss.incomplete_groups;
+
+    reorder.in_order += other.reorder.in_order;
+    reorder.reordered += other.reorder.reordered;
+    reorder.late += other.reorder.late;
+    reorder.gaps += other.reorder.gaps;
+
+    delivery.queue_depth += other.delivery.queue_depth;
+    delivery.delivered += other.delivery.delivered;
+    delivery.dropped += other.delivery.dropped;
+    delivery.latency_total += other.delivery.latency_total;
+    delivery.latency_max = std::max(delivery.latency_max, other.delivery.latency_max);
+    return *this;
+}
+
 SubscriptionDelegate::SubscriptionDelegate(const std::string& sourceId,
                                            const quicr::Namespace& quicrNamespace,
                                            const quicr::SubscribeIntent intent,
@@ -33,7 +82,8 @@ SubscriptionDelegate::SubscriptionDelegate(const std::string& sourceId,
                                            quicr::bytes e2eToken,
                                            std::shared_ptr<qmedia::QSubscriptionDelegate> qDelegate,
                                            std::shared_ptr<spdlog::logger> logger,
-                                           std::optional<sframe::CipherSuite> cipherSuite) :
+                                           std::shared_ptr<QSFrameContext> sframeContext,
+                                           std::shared_ptr<BufferPool> bufferPool) :
     canReceiveSubs(true),
     sourceId(sourceId),
     quicrNamespace(quicrNamespace),
@@ -43,27 +93,25 @@ SubscriptionDelegate::SubscriptionDelegate(const std::string& sourceId,
     e2eToken(e2eToken),
     qDelegate(std::move(qDelegate)),
     logger(std::move(logger)),
-    sframe_context(cipherSuite ? std::optional<QSFrameContext>(*cipherSuite) : std::nullopt)
+    sframe_context(std::move(sframeContext)),
+    buffer_pool(std::move(bufferPool)),
+    transport_assembler(buffer_pool)
 {
-    currentGroupId = 0;
-    currentObjectId = -1;
-
-    if (sframe_context)
+    if (!sframe_context)
     {
-        // TODO: This needs to be replaced with valid keying material
-        sframe::CipherSuite suite = *cipherSuite;
-        std::string salt_string = "Quicr epoch master key " + std::to_string(Fixed_Epoch);
-        sframe::bytes salt(salt_string.begin(), salt_string.end());
-        auto epoch_key = hkdf_extract(
-            suite,
-            salt,
-            {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f});
-        sframe_context->addEpoch(Fixed_Epoch, epoch_key);
-        sframe_context->enableEpoch(Fixed_Epoch);
+        LOGGER_WARN(logger, "[{0}] This subscription will not attempt to encrypt data", std::string(quicrNamespace));
+        return;
     }
-    else
+
+    // The controller's other delegates share the context, the keys go with the last one.
+    sframe_context->retainNamespace(quicr::Namespace(quicrNamespace.name(), Quicr_SFrame_Sig_Bits));
+}
+
+SubscriptionDelegate::~SubscriptionDelegate()
+{
+    if (sframe_context)
     {
-        LOGGER_WARN(logger, "[{0}] This subscription will not attempt to encrypt data", std::string(quicrNamespace));
+        sframe_context->releaseNamespace(quicr::Namespace(quicrNamespace.name(), Quicr_SFrame_Sig_Bits));
     }
 }
 
@@ -77,7 +125,8 @@ SubscriptionDelegate::create(const std::string& sourceId,
                              quicr::bytes e2eToken,
                              std::shared_ptr<qmedia::QSubscriptionDelegate> qDelegate,
                              std::shared_ptr<spdlog::logger> logger,
-                             std::optional<sframe::CipherSuite> cipherSuite)
+                             std::shared_ptr<QSFrameContext> sframeContext,
+                             std::shared_ptr<BufferPool> bufferPool)
 {
 
     return std::shared_ptr<SubscriptionDelegate>(new SubscriptionDelegate(sourceId,
@@ -89,7 +138,8 @@ SubscriptionDelegate::create(const std::string& sourceId,
                                                                           e2eToken,
                                                                           std::move(qDelegate),
                                                                           std::move(logger),
-                                                                          cipherSuite));
+                                                                          std::move(sframeContext),
+                                                                          std::move(bufferPool)));
 }
 
 void SubscriptionDelegate::onSubscribeResponse(const quicr::Namespace& /* quicr_namespace */,
@@ -112,7 +162,7 @@ void SubscriptionDelegate::onSubscriptionEnded(const quicr::Namespace& /* quicr_
  * data are passed to the client callback.
  */
 void SubscriptionDelegate::onSubscribedObject(const quicr::Name& quicrName,
-                                              uint8_t /*priority*/,
+                                              uint8_t priority,
                                               quicr::bytes&& data)
 {
     // LOGGER_DEBUG(logger, __FUNCTION__);
@@ -122,68 +172,92 @@ void SubscriptionDelegate::onSubscribedObject(const quicr::Name& quicrName,
         return;
     }
 
-    const auto groupId = quicrName.bits<std::uint32_t>(16, 32);
-    const auto objectId = quicrName.bits<std::uint16_t>(0, 16);
+    auto groupId = quicrName.bits<std::uint32_t>(16, 32);
+    auto objectId = quicrName.bits<std::uint16_t>(0, 16);
+
+    // Objects replayed after a re-subscribe or failover were already delivered.
+    if (!duplicateFilter.accept(groupId, objectId))
+    {
+        duplicateCount.fetch_add(1, std::memory_order_relaxed);
+        buffer_pool->release(std::move(data));
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (objectCount.load(std::memory_order_relaxed) > 0)
+    {
+        interArrival.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - lastArrival).count()));
+    }
+    lastArrival = now;
+    objectCount.fetch_add(1, std::memory_order_relaxed);
+    receivedBytes.fetch_add(data.size(), std::memory_order_relaxed);
+    objectSize.record(data.size());
 
     // group=5, object=0
-    // group=5, object=1
-    // group=6, object=2
-    // group=7, object=0 <---- group gap
-    // group=7, object=4 <---- object gap
-    // group=8, object=1 <---- object gap
+    // group=6, object=0 <---- interleaved with group 5, not a gap
+    // group=5, object=2 <---- object 1 missing until the reorder window passes
+    // group=8, object=0 <---- group 7 missing until the reorder window passes
+    // group=5, object=1 <---- recovered, if group 5 was already reported
 
-    if (groupId > currentGroupId)
+    lossTracker.add(groupId, objectId, now, incompleteGroups);
+    if (!incompleteGroups.empty()) notifyIncompleteGroups();
+
+    // Stale objects are dropped before spending time on decrypting them.
+    if (isExpired(groupId, now))
     {
-        if (groupId > currentGroupId + 1)
-        {
-            ++groupGapCount;
-            currentObjectId = 0;
-        }
-        ++groupCount;
+        expiredCount.fetch_add(1, std::memory_order_relaxed);
+        buffer_pool->release(std::move(data));
+        return;
     }
 
-    if (objectId > currentObjectId)
+    if (!isDelivering())
     {
-        if (objectId > currentObjectId + 1)
+        // A replacement layer starts with a group, the previous layer delivers up to there.
+        if (!awaitingGroup || objectId != 0)
         {
-            ++objectGapCount;
+            buffer_pool->release(std::move(data));
+            return;
         }
-        ++objectCount;
-    }
 
-    currentGroupId = groupId;
-    currentObjectId = objectId;
+        awaitingGroup = false;
+        if (const auto replaced = replacedLayer.lock()) replaced->stopDelivering();
+        replacedLayer.reset();
+        delivering.store(true, std::memory_order_release);
+        LOGGER_INFO(logger, "Switched {0} to layer {1}", sourceId, std::string(quicrNamespace));
+    }
 
     quicr::bytes output_buffer;
     if (sframe_context)
     {
-        // Decrypt the received data using sframe
+        // Decrypt the received data using sframe, in place: the epoch header
+        // is shifted off and the tag trimmed, the allocation is delivered.
         try
         {
-            auto buf = quicr::messages::MessageBuffer(data);
+            auto buf = quicr::messages::MessageBuffer(std::move(data));
             quicr::uintVar_t epoch;
             buf >> epoch;
-            const auto ciphertext = buf.take();
-            output_buffer = quicr::bytes(ciphertext.size());
-            auto cleartext = sframe_context->unprotect(epoch,
-                                                       quicr::Namespace(quicrName, Quicr_SFrame_Sig_Bits),
-                                                        quicrName.bits<std::uint64_t>(0, 48),
-                                                        output_buffer,
-                                                        ciphertext);
+            output_buffer = buf.take();
+            const auto sframe_namespace = quicr::Namespace(quicrName, Quicr_SFrame_Sig_Bits);
+            const auto counter = quicrName.bits<std::uint64_t>(0, 48);
+            auto cleartext = sframe_context->unprotect(epoch, sframe_namespace, counter, output_buffer);
             output_buffer.resize(cleartext.size());
         }
         catch (const std::exception& e)
         {
+            decryptFailures.fetch_add(1, std::memory_order_relaxed);
             LOGGER_ERROR(logger, "Exception trying to decrypt sframe: {0}", e.what());
             return;
         }
         catch (const std::string& s)
         {
+            decryptFailures.fetch_add(1, std::memory_order_relaxed);
             LOGGER_ERROR(logger, "Exception trying to decrypt sframe: {0}", s);
             return;
         }
         catch (...)
         {
+            decryptFailures.fetch_add(1, std::memory_order_relaxed);
             LOGGER_ERROR(logger, "Unknown error trying to decrypt sframe");
             return;
         }
@@ -193,10 +267,223 @@ void SubscriptionDelegate::onSubscribedObject(const quicr::Name& quicrName,
         output_buffer = std::move(data);
     }
 
-    // Forward the object on.
+    if (fragment_assembler)
+    {
+        // The header is part of the (decrypted) payload, so it is authenticated.
+        const auto fragment = FragmentHeader::decode(output_buffer);
+        if (!fragment || fragment->index > objectId)
+        {
+            LOGGER_WARN(logger, "Fragment {0} has no valid header", std::string(quicrName));
+            buffer_pool->release(std::move(output_buffer));
+            return;
+        }
+
+        // Fragments carry consecutive object ids; the object keeps the first.
+        objectId = static_cast<std::uint16_t>(objectId - fragment->index);
+        auto object = fragment_assembler->add(std::uint64_t(groupId) << 16 | objectId,
+                                              fragment->object_length,
+                                              fragment->offset,
+                                              std::span(output_buffer).subspan(FragmentHeader::Size));
+        buffer_pool->release(std::move(output_buffer));
+        if (!object) return;
+
+        output_buffer = std::move(*object);
+    }
+
+    if (reorder_buffer)
+    {
+        std::lock_guard<std::mutex> _(reorder_mutex);
+        reorder_buffer->push(groupId, objectId, priority, std::move(output_buffer), now, reorder_released);
+        deliverReleased();
+        return;
+    }
+
+    deliver({
+        .data = std::move(output_buffer),
+        .groupId = groupId,
+        .objectId = objectId,
+        .priority = priority,
+        .received = now,
+    });
+}
+
+void SubscriptionDelegate::enableReorderBuffer(const ReorderBufferConfig& config)
+{
+    std::lock_guard<std::mutex> _(reorder_mutex);
+    reorder_buffer.emplace(config);
+
+    // A group is incomplete for the decoder once the buffer gives up on it.
+    lossTracker.setReorderWindow(config.latency);
+}
+
+void SubscriptionDelegate::notifyIncompleteGroups()
+{
+    for (const auto groupId : incompleteGroups)
+    {
+        try
+        {
+            qDelegate->groupIncomplete(quicrNamespace, groupId);
+        }
+        catch (const std::exception& e)
+        {
+            LOGGER_ERROR(logger, "Exception trying to report incomplete group: {0}", e.what());
+        }
+        catch (...)
+        {
+            LOGGER_ERROR(logger, "Unknown error trying to report incomplete group");
+        }
+    }
+    incompleteGroups.clear();
+}
+
+void SubscriptionDelegate::flushReorderBuffer()
+{
+    std::lock_guard<std::mutex> _(reorder_mutex);
+    if (!reorder_buffer) return;
+
+    reorder_buffer->flush(ReorderBuffer::Clock::now(), reorder_released);
+    deliverReleased();
+}
+
+void SubscriptionDelegate::deliverReleased()
+{
+    // NOTE: caller must lock reorder_mutex, which keeps deliveries in order
+
+    for (auto& object : reorder_released)
+    {
+        released_batch.push_back({
+            .data = std::move(object.data),
+            .groupId = object.group_id,
+            .objectId = object.object_id,
+            .priority = object.priority,
+            .received = object.arrival,
+        });
+    }
+    reorder_released.clear();
+
+    // Without a delivery queue, everything released together goes out in one call.
+    if (!delivery_queue)
+    {
+        if (!released_batch.empty()) forward(released_batch);
+    }
+    else
+    {
+        for (auto& object : released_batch)
+        {
+            deliver(std::move(object));
+        }
+    }
+    released_batch.clear();
+}
+
+void SubscriptionDelegate::deliver(ObjectView&& object)
+{
+    if (!delivery_queue)
+    {
+        forward(std::span<ObjectView>(&object, 1));
+        return;
+    }
+
+    auto queued = QueuedObject{
+        .object = std::move(object),
+        .queued = std::chrono::steady_clock::now(),
+    };
+    while (!delivery_queue->push(std::move(queued)))
+    {
+        if (overflow_policy == DeliveryOverflowPolicy::drop_newest || delivery_pool.expired())
+        {
+            ++delivery_dropped;
+            buffer_pool->release(std::move(queued.object.data));
+            return;
+        }
+
+        if (overflow_policy == DeliveryOverflowPolicy::drop_oldest)
+        {
+            if (auto oldest = delivery_queue->pop())
+            {
+                ++delivery_dropped;
+                buffer_pool->release(std::move(oldest->object.data));
+            }
+            continue;
+        }
+
+        // Block until the application catches up.
+        scheduleDelivery();
+        std::this_thread::yield();
+    }
+
+    scheduleDelivery();
+}
+
+void SubscriptionDelegate::replaceLayer(std::weak_ptr<SubscriptionDelegate> replaced)
+{
+    replacedLayer = std::move(replaced);
+    awaitingGroup = true;
+    delivering.store(false, std::memory_order_release);
+}
+
+void SubscriptionDelegate::enableDeliveryExecutor(std::weak_ptr<WorkStealingPool> pool,
+                                                  const DeliveryExecutorConfig& config)
+{
+    delivery_queue = std::make_unique<MPMCQueue<QueuedObject>>(config.queue_capacity);
+    drain_batch.reserve(Max_Drain_Batch);
+    delivery_pool = std::move(pool);
+    overflow_policy = config.overflow_policy;
+}
+
+void SubscriptionDelegate::scheduleDelivery()
+{
+    // A drain that is already queued or running will pick the object up.
+    if (delivery_scheduled.exchange(true, std::memory_order_acq_rel)) return;
+
+    const auto pool = delivery_pool.lock();
+    if (!pool)
+    {
+        // The executor was stopped along with the controller.
+        delivery_scheduled = false;
+        return;
+    }
+
+    pool->submit([self = shared_from_this()] { self->drainDeliveryQueue(); });
+}
+
+void SubscriptionDelegate::drainDeliveryQueue()
+{
+    for (std::size_t count = 0; count < Max_Drain_Batch; ++count)
+    {
+        auto queued = delivery_queue->pop();
+        if (!queued) break;
+
+        // Read the clock after the pop, an object queued during the batch
+        // would otherwise come out with a negative latency.
+        const auto latency = std::chrono::steady_clock::now() - queued->queued;
+        const auto latency_us = static_cast<std::uint64_t>(
+            std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), 0));
+
+        // Only one drain runs at a time, so the max has a single writer.
+        delivery_latency_total_us += latency_us;
+        if (latency_us > delivery_latency_max_us) delivery_latency_max_us = latency_us;
+        ++delivered_count;
+
+        drain_batch.push_back(std::move(queued->object));
+    }
+
+    // Whatever queued up while the application was busy goes out in one call.
+    if (!drain_batch.empty()) forward(drain_batch);
+    drain_batch.clear();
+
+    // As for publishing: look again after clearing the flag, and yield
+    // between batches so other subscriptions get a turn.
+    delivery_scheduled.exchange(false, std::memory_order_acq_rel);
+    if (!delivery_queue->empty()) scheduleDelivery();
+}
+
+void SubscriptionDelegate::forward(std::span<ObjectView> objects)
+{
+    // Forward the objects on.
     try
     {
-        qDelegate->subscribedObject(this->quicrNamespace, std::move(output_buffer), groupId, objectId);
+        qDelegate->subscribedObjects(this->quicrNamespace, objects);
     }
     catch (const std::exception& e)
     {
@@ -212,8 +499,78 @@ void SubscriptionDelegate::onSubscribedObject(const quicr::Name& quicrName,
     }
 }
 
-void SubscriptionDelegate::onSubscribedObjectFragment(const quicr::Name&, uint8_t, const uint64_t&, bool, quicr::bytes&&)
+void SubscriptionDelegate::enableFragmentation(const FragmentAssemblerConfig& config)
 {
+    fragment_assembler.emplace(buffer_pool, config);
+}
+
+bool SubscriptionDelegate::isExpired(std::uint32_t groupId, std::chrono::steady_clock::time_point now)
+{
+    // Objects carry no timestamp, their group's expected start stands in for it.
+    const auto lateness = groupClock.lateness(groupId, now);
+    const auto deadline = std::chrono::milliseconds(deadlineMs.load(std::memory_order_relaxed));
+    return deadline.count() > 0 && lateness > deadline;
+}
+
+void SubscriptionDelegate::prepareKeys()
+{
+    if (!sframe_context) return;
+
+    try
+    {
+        sframe_context->prepareKeys(quicr::Namespace(quicrNamespace.name(), Quicr_SFrame_Sig_Bits));
+    }
+    catch (const std::exception& e)
+    {
+        LOGGER_ERROR(logger, "Failed to prepare keys for {0}: {1}", std::string(quicrNamespace), e.what());
+    }
+}
+
+SubscriptionStats SubscriptionDelegate::getStats() const
+{
+    SubscriptionStats stats;
+    stats.objects = objectCount.load(std::memory_order_relaxed);
+    stats.bytes = receivedBytes.load(std::memory_order_relaxed);
+    stats.decrypt_failures = decryptFailures.load(std::memory_order_relaxed);
+    stats.expired = expiredCount.load(std::memory_order_relaxed);
+    stats.duplicates = duplicateCount.load(std::memory_order_relaxed);
+    stats.inter_arrival = interArrival.snapshot();
+    stats.object_size = objectSize.snapshot();
+
+    stats.loss = lossTracker.getStats();
+
+    // Both are set up before subscribing and only their counters change after.
+    stats.fragments = transport_assembler.getStats();
+    if (fragment_assembler)
+    {
+        const auto published = fragment_assembler->getStats();
+        stats.fragments.reassembled += published.reassembled;
+        stats.fragments.abandoned += published.abandoned;
+    }
+    if (reorder_buffer) stats.reorder = reorder_buffer->getStats();
+
+    stats.delivery.queue_depth = delivery_queue ? delivery_queue->size() : 0;
+    stats.delivery.delivered = delivered_count.load(std::memory_order_relaxed);
+    stats.delivery.dropped = delivery_dropped.load(std::memory_order_relaxed);
+    stats.delivery.latency_total = std::chrono::microseconds(delivery_latency_total_us.load(std::memory_order_relaxed));
+    stats.delivery.latency_max = std::chrono::microseconds(delivery_latency_max_us.load(std::memory_order_relaxed));
+    return stats;
+}
+
+void SubscriptionDelegate::onSubscribedObjectFragment(const quicr::Name& quicrName,
+                                                      uint8_t priority,
+                                                      const uint64_t& offset,
+                                                      bool is_last_fragment,
+                                                      quicr::bytes&& data)
+{
+    // The transport splits the object as published, the name is the same for
+    // every fragment.
+    auto object = transport_assembler.addTransportFragment(
+        quicrName.bits<std::uint64_t>(0, 64), offset, is_last_fragment, data);
+    buffer_pool->release(std::move(data));
+    if (!object) return;
+
+    onSubscribedObject(quicrName, priority, std::move(*object));
 }
 
 void SubscriptionDelegate::subscribe(std::shared_ptr<quicr::Client> client, const quicr::TransportMode transport_mode)
@@ -256,8 +613,8 @@ PublicationDelegate::PublicationDelegate(std::shared_ptr<qmedia::QPublicationDel
                                          const std::vector<std::uint8_t>& priority,
                                          const std::vector<std::uint16_t>& expiry,
                                          std::shared_ptr<spdlog::logger> logger,
-                                         const std::optional<sframe::CipherSuite> cipherSuite) :
-    // canPublish(true),
+                                         std::shared_ptr<QSFrameContext> sframeContext,
+                                         std::shared_ptr<BufferPool> bufferPool) :
     sourceId(sourceId),
     originUrl(originUrl),
     authToken(authToken),
@@ -270,19 +627,14 @@ PublicationDelegate::PublicationDelegate(std::shared_ptr<qmedia::QPublicationDel
     expiry(expiry),
     qDelegate(std::move(qDelegate)),
     logger(std::move(logger)),
-    sframe_context(cipherSuite ? std::optional<QSFrameContext>(*cipherSuite) : std::nullopt)
+    sframe_context(std::move(sframeContext)),
+    buffer_pool(std::move(bufferPool))
 {
     if (sframe_context) {
-        // TODO: This needs to be replaced with valid keying material
-        std::string salt_string = "Quicr epoch master key " + std::to_string(Fixed_Epoch);
-        sframe::bytes salt(salt_string.begin(), salt_string.end());
-        auto epoch_key = hkdf_extract(
-            *cipherSuite,
-            salt,
-            std::vector<std::uint8_t>{
-                0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f});
-        sframe_context->addEpoch(Fixed_Epoch, epoch_key);
-        sframe_context->enableEpoch(Fixed_Epoch);
+        sframe_context->retainNamespace(quicr::Namespace(quicrNamespace.name(), Quicr_SFrame_Sig_Bits));
+        header_epoch = sframe_context->currentEpoch().value_or(0);
+        epoch_header = encodeEpoch(header_epoch);
+        epoch_header_size = epoch_header.size();
     } else {
         LOGGER_WARN(logger, "[{0}] This publication will not attempt to encrypt data", std::string(quicrNamespace));
     }
@@ -295,6 +647,15 @@ PublicationDelegate::PublicationDelegate(std::shared_ptr<qmedia::QPublicationDel
         this->priority.emplace_back(priority[0]);
     }
 }
+
+PublicationDelegate::~PublicationDelegate()
+{
+    if (sframe_context)
+    {
+        sframe_context->releaseNamespace(quicr::Namespace(quicrNamespace.name(), Quicr_SFrame_Sig_Bits));
+    }
+}
+
 std::shared_ptr<PublicationDelegate> PublicationDelegate::create(std::shared_ptr<qmedia::QPublicationDelegate> qDelegate,
                                                                  const std::string& sourceId,
                                                                  const quicr::Namespace& quicrNamespace,
@@ -305,7 +666,8 @@ std::shared_ptr<PublicationDelegate> PublicationDelegate::create(std::shared_ptr
                                                                  const std::vector<std::uint8_t>& priority,
                                                                  const std::vector<std::uint16_t>& expiry,
                                                                  std::shared_ptr<spdlog::logger> logger,
-                                                                 const std::optional<sframe::CipherSuite> cipherSuite)
+                                                                 std::shared_ptr<QSFrameContext> sframeContext,
+                                                                 std::shared_ptr<BufferPool> bufferPool)
 {
     return std::shared_ptr<PublicationDelegate>(new PublicationDelegate(std::move(qDelegate),
                                                                         sourceId,
@@ -317,7 +679,8 @@ std::shared_ptr<PublicationDelegate> PublicationDelegate::create(std::shared_ptr
                                                                         priority,
                                                                         expiry,
                                                                         logger,
-                                                                        cipherSuite));
+                                                                        std::move(sframeContext),
+                                                                        std::move(bufferPool)));
 }
 
 void PublicationDelegate::onPublishIntentResponse(const quicr::Namespace& quicr_namespace,
@@ -364,23 +727,461 @@ void PublicationDelegate::publishNamedObject(std::shared_ptr<quicr::Client> clie
                                              const std::uint8_t* data,
                                              std::size_t len,
                                              bool groupFlag,
-                                             std::vector<qtransport::MethodTraceItem> &&trace)
+                                             TraceBuffer&& trace)
+{
+    publishNamedObject(std::move(client), std::span<const std::uint8_t>(data, len), groupFlag, std::move(trace));
+}
+
+void PublicationDelegate::publishNamedObject(std::shared_ptr<quicr::Client> client,
+                                             std::span<const std::uint8_t> data,
+                                             bool groupFlag,
+                                             TraceBuffer&& trace)
+{
+    const std::lock_guard<std::mutex> _(publish_mutex);
+    if (!canPublish(client, data.size())) return;
+
+    if (publish_queue)
+    {
+        // The worker runs after the caller's buffer is gone, so copy it with
+        // headroom for the worker to encrypt in place.
+        auto buffer = allocateObjectBuffer(data.size());
+        std::copy(data.begin(), data.end(), buffer.payload().begin());
+        publishBuffer(client, std::move(buffer), groupFlag, std::move(trace));
+        return;
+    }
+
+    std::uint8_t pri;
+    std::uint16_t exp;
+    const auto quicrName = nextObjectName(groupFlag, pri, exp, fragmentCount(data.size()));
+
+    if (fragment_size)
+    {
+        sendFragments(client, quicrName, pri, exp, data, trace);
+        return;
+    }
+
+    quicr::bytes to_publish;
+    if (sframe_context)
+    {
+        // Encryption reads the caller's buffer directly, no intermediate copy.
+        if (!encrypt(quicrName, data, to_publish, trace)) return;
+    }
+    else
+    {
+        // The caller keeps ownership of data, so this is the one unavoidable copy.
+        to_publish = buffer_pool->acquire(data.size());
+        std::copy(data.begin(), data.end(), to_publish.begin());
+    }
+
+    send(std::move(client), quicrName, pri, exp, std::move(to_publish), std::move(trace));
+}
+
+void PublicationDelegate::publishNamedObject(std::shared_ptr<quicr::Client> client,
+                                             quicr::bytes&& data,
+                                             bool groupFlag,
+                                             TraceBuffer&& trace)
+{
+    const std::lock_guard<std::mutex> _(publish_mutex);
+    if (!canPublish(client, data.size())) return;
+
+    publishOwned(client, std::move(data), groupFlag, std::move(trace));
+}
+
+void PublicationDelegate::publishNamedObjects(std::shared_ptr<quicr::Client> client,
+                                              std::span<PublishObject> objects,
+                                              TraceBuffer&& trace)
+{
+    const std::lock_guard<std::mutex> _(publish_mutex);
+    for (auto& object : objects)
+    {
+        if (!canPublish(client, object.data.size())) continue;
+
+        // Only the first object is traced, the rest carry its start time.
+        publishOwned(client, std::move(object.data), object.groupFlag, std::exchange(trace, trace.untraced()));
+    }
+}
+
+void PublicationDelegate::publishOwned(const std::shared_ptr<quicr::Client>& client,
+                                       quicr::bytes&& data,
+                                       bool groupFlag,
+                                       TraceBuffer&& trace)
+{
+    // NOTE: caller must lock publish_mutex
+
+    PendingObject object;
+    object.client = client;
+    object.name = nextObjectName(groupFlag, object.priority, object.expiry, fragmentCount(data.size()));
+    object.data = std::move(data);
+    object.trace = std::move(trace);
+
+    dispatch(std::move(object), groupFlag);
+}
+
+void PublicationDelegate::publishNamedObject(std::shared_ptr<quicr::Client> client,
+                                             ObjectBuffer&& data,
+                                             bool groupFlag,
+                                             TraceBuffer&& trace)
+{
+    const std::lock_guard<std::mutex> _(publish_mutex);
+    if (!canPublish(client, data.size())) return;
+
+    publishBuffer(client, std::move(data), groupFlag, std::move(trace));
+}
+
+void PublicationDelegate::publishBuffer(const std::shared_ptr<quicr::Client>& client,
+                                        ObjectBuffer&& data,
+                                        bool groupFlag,
+                                        TraceBuffer&& trace)
+{
+    // NOTE: caller must lock publish_mutex
+
+    const auto header_size = sframe_context ? epoch_header_size.load() : 0;
+    const auto trailer_size = sframe_context ? QSFrameContext::Max_Tag_Size : 0;
+    if (data.headerSize() != header_size || data.trailerSize() < trailer_size)
+    {
+        // Not laid out for this publication, copy the payload into a buffer that is.
+        LOGGER_DEBUG(logger, "Object buffer headroom mismatch for {0}", std::string(quicrNamespace));
+        auto copy = allocateObjectBuffer(data.size());
+        std::copy(data.payload().begin(), data.payload().end(), copy.payload().begin());
+        buffer_pool->release(std::move(data).release());
+        data = std::move(copy);
+    }
+
+    PendingObject object;
+    object.client = client;
+    object.name = nextObjectName(groupFlag, object.priority, object.expiry, fragmentCount(data.size()));
+    object.in_place = true;
+    object.header_size = data.headerSize();
+    object.payload_size = data.size();
+    object.data = std::move(data).release();
+    object.trace = std::move(trace);
+
+    dispatch(std::move(object), groupFlag);
+}
+
+void PublicationDelegate::dispatch(PendingObject&& object, bool groupFlag)
+{
+    // NOTE: caller must lock publish_mutex
+
+    if (!publish_queue)
+    {
+        process(std::move(object));
+        return;
+    }
+
+    // Once an object of a group is lost the rest of it can't be decoded, so
+    // the drop_group policy skips ahead to the next group.
+    if (dropping_group && !groupFlag)
+    {
+        ++dropped_count;
+        buffer_pool->release(std::move(object.data));
+        return;
+    }
+    dropping_group = false;
+
+    if (!publish_queue->push(std::move(object)))
+    {
+        LOGGER_DEBUG(logger, "Publish queue full for {0}, dropping object", std::string(quicrNamespace));
+        ++dropped_count;
+        dropping_group = drop_policy == PublishDropPolicy::drop_group;
+        buffer_pool->release(std::move(object.data));
+        return;
+    }
+
+    ++queued_count;
+    scheduleDrain();
+}
+
+void PublicationDelegate::process(PendingObject&& object)
+{
+    if (fragment_size)
+    {
+        const auto header_size = object.in_place ? object.header_size : 0;
+        const auto payload_size = object.in_place ? object.payload_size : object.data.size();
+        sendFragments(object.client,
+                      object.name,
+                      object.priority,
+                      object.expiry,
+                      std::span<const std::uint8_t>(object.data).subspan(header_size, payload_size),
+                      object.trace);
+        buffer_pool->release(std::move(object.data));
+        return;
+    }
+
+    if (sframe_context)
+    {
+        if (object.in_place)
+        {
+            if (!encryptInPlace(object.name, object.data, object.header_size, object.payload_size, object.trace))
+            {
+                return;
+            }
+        }
+        else
+        {
+            quicr::bytes to_publish;
+            const auto encrypted = encrypt(object.name, object.data, to_publish, object.trace);
+
+            // The plaintext has been consumed either way, recycle it.
+            buffer_pool->release(std::move(object.data));
+            if (!encrypted) return;
+
+            object.data = std::move(to_publish);
+        }
+    }
+    else if (object.in_place)
+    {
+        // No headroom was reserved, the payload starts at the front.
+        object.data.resize(object.payload_size);
+    }
+
+    // We own the buffer, hand it straight to the transport.
+    send(std::move(object.client),
+         object.name,
+         object.priority,
+         object.expiry,
+         std::move(object.data),
+         std::move(object.trace));
+}
+
+void PublicationDelegate::sendFragments(const std::shared_ptr<quicr::Client>& client,
+                                        const quicr::Name& quicrName,
+                                        std::uint8_t pri,
+                                        std::uint16_t exp,
+                                        std::span<const std::uint8_t> payload,
+                                        const TraceBuffer& trace)
+{
+    const auto length = fragmentLength(payload.size());
+    const auto first_object_id = quicrName.bits<std::uint16_t>(0, 16);
+
+    FragmentHeader header;
+    header.object_length = static_cast<std::uint32_t>(payload.size());
+
+    for (std::size_t offset = 0; offset < payload.size(); offset += length, ++header.index)
+    {
+        const auto fragment = payload.subspan(offset, std::min(length, payload.size() - offset));
+        const auto fragment_name = (quicrName & ~Object_ID_Mask)
+                                   | (0x0_name | static_cast<std::uint16_t>(first_object_id + header.index));
+        header.offset = static_cast<std::uint32_t>(offset);
+
+        // The header goes in front of the fragment and is encrypted with it,
+        // so a relay can't move fragments around within the object.
+        const auto header_size = sframe_context ? epoch_header_size.load() : 0;
+        const auto trailer_size = sframe_context ? QSFrameContext::Max_Tag_Size : 0;
+        const auto plaintext_size = FragmentHeader::Size + fragment.size();
+        auto wire = buffer_pool->acquire(header_size + plaintext_size + trailer_size);
+        header.encode(std::span(wire).subspan(header_size));
+        std::copy(fragment.begin(), fragment.end(), wire.begin() + header_size + FragmentHeader::Size);
+
+        auto fragment_trace = trace;
+        if (sframe_context)
+        {
+            // Each fragment is encrypted and sent before the next one is
+            // touched, so the first bytes go out without waiting for the rest.
+            if (!encryptInPlace(fragment_name, wire, header_size, plaintext_size, fragment_trace))
+            {
+                buffer_pool->release(std::move(wire));
+                return;
+            }
+        }
+        else
+        {
+            wire.resize(plaintext_size);
+        }
+
+        send(client, fragment_name, pri, exp, std::move(wire), std::move(fragment_trace));
+    }
+}
+
+std::size_t PublicationDelegate::fragmentLength(std::size_t size) const
+{
+    // Fragments get consecutive 16 bit object ids; grow them rather than
+    // run out of ids for very large objects.
+    constexpr std::size_t Max_Fragments = 1024;
+    return std::max(fragment_size, (size + Max_Fragments - 1) / Max_Fragments);
+}
+
+std::size_t PublicationDelegate::fragmentCount(std::size_t size) const
+{
+    if (!fragment_size) return 1;
+
+    const auto length = fragmentLength(size);
+    return std::max<std::size_t>((size + length - 1) / length, 1);
+}
+
+void PublicationDelegate::enablePacing(std::weak_ptr<PacedSender> pacer,
+                                       std::uint32_t bitrate,
+                                       const PacerConfig& config)
+{
+    const std::lock_guard<std::mutex> _(publish_mutex);
+    {
+        const std::lock_guard<std::mutex> _(pacing_mutex);
+        this->pacer = std::move(pacer);
+        pacer_config = config;
+        if (bitrate) token_bucket.emplace(bitrate * 1000 / 8 * config.pacing_factor, config.burst);
+    }
+    pacing = true;
+
+    LOGGER_DEBUG(logger, "Pacing {0} at {1} kbps", std::string(quicrNamespace), bitrate);
+}
+
+bool PublicationDelegate::setPacingBitrate(std::uint32_t bitrate)
+{
+    if (!pacing) return false;
+
+    // The bucket stays at a rate of 0, objects it already queued keep their order.
+    const std::lock_guard<std::mutex> _(pacing_mutex);
+    if (token_bucket)
+    {
+        token_bucket->setRate(bitrate * 1000 / 8 * pacer_config.pacing_factor);
+    }
+    else if (bitrate)
+    {
+        token_bucket.emplace(bitrate * 1000 / 8 * pacer_config.pacing_factor, pacer_config.burst);
+    }
+
+    return true;
+}
+
+void PublicationDelegate::enableFragmentation(std::size_t size)
+{
+    const std::lock_guard<std::mutex> _(publish_mutex);
+    fragment_size = size;
+}
+
+void PublicationDelegate::enablePipeline(std::weak_ptr<WorkStealingPool> pool, const PublishPipelineConfig& config)
+{
+    const std::lock_guard<std::mutex> _(publish_mutex);
+    publish_queue = std::make_unique<SPSCQueue<PendingObject>>(config.queue_capacity);
+    pipeline_pool = std::move(pool);
+    drop_policy = config.drop_policy;
+}
+
+void PublicationDelegate::scheduleDrain()
+{
+    // A drain that is already queued or running will pick the object up.
+    if (drain_scheduled.exchange(true, std::memory_order_acq_rel)) return;
+
+    const auto pool = pipeline_pool.lock();
+    if (!pool)
+    {
+        // The pipeline was stopped along with the controller.
+        drain_scheduled = false;
+        return;
+    }
+
+    pool->submit([self = shared_from_this()] { self->drainPublishQueue(); });
+}
+
+void PublicationDelegate::drainPublishQueue()
+{
+    for (std::size_t count = 0; count < Max_Drain_Batch; ++count)
+    {
+        auto object = publish_queue->pop();
+        if (!object) break;
+
+        if (removed)
+        {
+            buffer_pool->release(std::move(object->data));
+            continue;
+        }
+
+        object->trace.add("qMediaDelegate:publishNamedObject:dequeued");
+        process(std::move(*object));
+    }
+
+    // Anything pushed while the flag was still set relied on this drain, so
+    // look again after clearing it. Yielding between batches lets other
+    // publications run when this one is busy.
+    drain_scheduled.exchange(false, std::memory_order_acq_rel);
+    if (!publish_queue->empty()) scheduleDrain();
+}
+
+PublicationStats PublicationDelegate::getStats() const
+{
+    PublicationStats stats;
+    stats.queue_depth = publish_queue ? publish_queue->size() : 0;
+    stats.queued = queued_count;
+    stats.dropped = dropped_count;
+    stats.sent = sent_count;
+    stats.pacing_queue = paced_pending;
+    stats.paced = paced_count;
+    stats.pacing_delay_total = std::chrono::microseconds(pacing_delay_total_us);
+    stats.pacing_delay_max = std::chrono::microseconds(pacing_delay_max_us);
+    return stats;
+}
+
+void PublicationDelegate::prepareKeys()
+{
+    if (!sframe_context) return;
+
+    try
+    {
+        sframe_context->prepareKeys(quicr::Namespace(quicrNamespace.name(), Quicr_SFrame_Sig_Bits));
+    }
+    catch (const std::exception& e)
+    {
+        LOGGER_ERROR(logger, "Failed to prepare keys for {0}: {1}", std::string(quicrNamespace), e.what());
+    }
+}
+
+ObjectBuffer PublicationDelegate::allocateObjectBuffer(std::size_t size) const
 {
+    const auto header_size = sframe_context ? epoch_header_size.load() : 0;
+    const auto trailer_size = sframe_context ? QSFrameContext::Max_Tag_Size : 0;
+    auto storage = buffer_pool->acquire(header_size + size + trailer_size);
+    return ObjectBuffer(std::move(storage), header_size, size, trailer_size);
+}
+
+void PublicationDelegate::invalidate()
+{
+    const std::lock_guard<std::mutex> _(publish_mutex);
+    removed = true;
+}
+
+bool PublicationDelegate::canPublish(const std::shared_ptr<quicr::Client>& client, std::size_t size) const
+{
+    // NOTE: caller must lock publish_mutex
+
+    if (removed)
+    {
+        LOGGER_DEBUG(logger, "Publication {0} was removed, dropping object", std::string(quicrNamespace));
+        return false;
+    }
+
+    if (paused) return false;
+
     // If the object data isn't present, return
-    if (len == 0)
+    if (size == 0)
     {
         LOGGER_WARN(logger, "Cannot send empty object");
-        return;
+        return false;
     }
 
     if (!client)
     {
         LOGGER_ERROR(logger, "Client was null, can't Publish");
-        return;
+        return false;
     }
 
-    std::uint8_t pri = priority[0];
-    std::uint16_t exp = expiry[0];
+    return true;
+}
+
+quicr::Name PublicationDelegate::nextObjectName(bool groupFlag,
+                                                std::uint8_t& pri,
+                                                std::uint16_t& exp,
+                                                std::size_t object_count)
+{
+    // Ids wrapping within a group would repeat names, and with them SFrame
+    // nonces; an object that doesn't fit in the group starts the next one.
+    if (!groupFlag && std::size_t(objectId) + object_count > std::numeric_limits<std::uint16_t>::max())
+    {
+        LOGGER_WARN(logger, "Group {0} of {1} ran out of object ids", groupId, std::string(quicrNamespace));
+        groupFlag = true;
+    }
+
+    pri = priority[0];
+    exp = expiry[0];
     quicr::Name quicrName(quicrNamespace.name());
 
     if (groupFlag)
@@ -398,64 +1199,198 @@ void PublicationDelegate::publishNamedObject(std::shared_ptr<quicr::Client> clie
         quicrName = (0x0_name | ++objectId) | (quicrName & ~Object_ID_Mask);
     }
 
-    quicr::bytes to_publish;
-    if (sframe_context)
+    // Fragments of the object take the ids that follow.
+    objectId += static_cast<std::uint16_t>(object_count - 1);
+
+    return quicrName;
+}
+
+bool PublicationDelegate::encrypt(const quicr::Name& quicrName,
+                                  std::span<const std::uint8_t> plaintext,
+                                  quicr::bytes& output,
+                                  TraceBuffer& trace)
+{
+    // Encrypt using sframe
+    try
     {
-        // Encrypt using sframe
-        try
-        {
-            trace.push_back({"qMediaDelegate:publishNamedObject:beforeEncrypt", trace.front().start_time});
-            quicr::bytes output_buffer(len + 16);
-            auto ciphertext = sframe_context->protect(quicr::Namespace(quicrName, Quicr_SFrame_Sig_Bits),
-                                                      quicrName.bits<std::uint64_t>(0, 48),
-                                                      output_buffer,
-                                                      {data, len});
-            output_buffer.resize(ciphertext.size());
-            auto buf = quicr::messages::MessageBuffer(output_buffer.size() + 8);
-            buf << quicr::uintVar_t(Fixed_Epoch);
-            buf.push(std::move(output_buffer));
-            trace.push_back({"qMediaDelegate:publishNamedObject:afterEncrypt", trace.front().start_time});
-            to_publish = buf.take();
-        }
-        catch (const std::exception& e)
+        trace.add("qMediaDelegate:publishNamedObject:beforeEncrypt");
+        const auto epoch = sealingEpoch();
+
+        // Build the wire buffer (epoch, ciphertext, tag) in a single pooled buffer.
+        const auto header_size = epoch_header.size();
+        output = buffer_pool->acquire(header_size + plaintext.size() + QSFrameContext::Max_Tag_Size);
+        std::copy(epoch_header.begin(), epoch_header.end(), output.begin());
+        const auto ciphertext = sframe_context->protect(epoch,
+                                                        quicr::Namespace(quicrName, Quicr_SFrame_Sig_Bits),
+                                                        quicrName.bits<std::uint64_t>(0, 48),
+                                                        sframe::output_bytes(output).subspan(header_size),
+                                                        plaintext);
+        output.resize(header_size + ciphertext.size());
+        trace.add("qMediaDelegate:publishNamedObject:afterEncrypt");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        LOGGER_ERROR(logger, "Exception trying to encrypt: {0}", e.what());
+    }
+    catch (const std::string& s)
+    {
+        LOGGER_ERROR(logger, "Exception trying to encrypt: {0}", s);
+    }
+    catch (...)
+    {
+        LOGGER_ERROR(logger, "Unknown error trying to encrypt");
+    }
+
+    return false;
+}
+
+bool PublicationDelegate::encryptInPlace(const quicr::Name& quicrName,
+                                         quicr::bytes& wire,
+                                         std::size_t header_size,
+                                         std::size_t payload_size,
+                                         TraceBuffer& trace)
+{
+    // NOTE: wire must be laid out as [epoch header][payload][tag room]
+    try
+    {
+        trace.add("qMediaDelegate:publishNamedObject:beforeEncrypt");
+        const auto epoch = sealingEpoch();
+        if (epoch_header.size() != header_size)
         {
-            LOGGER_ERROR(logger, "Exception trying to encrypt: {0}", e.what());
-            return;
+            // The epoch's encoding changed size after the buffer was laid out.
+            wire.resize(std::max(wire.size(), epoch_header.size() + payload_size + QSFrameContext::Max_Tag_Size));
+            std::memmove(wire.data() + epoch_header.size(), wire.data() + header_size, payload_size);
         }
-        catch (const std::string& s)
+
+        std::copy(epoch_header.begin(), epoch_header.end(), wire.begin());
+        const auto ciphertext = sframe_context->protect(epoch,
+                                                        quicr::Namespace(quicrName, Quicr_SFrame_Sig_Bits),
+                                                        quicrName.bits<std::uint64_t>(0, 48),
+                                                        sframe::output_bytes(wire).subspan(epoch_header.size()),
+                                                        payload_size);
+        wire.resize(epoch_header.size() + ciphertext.size());
+        trace.add("qMediaDelegate:publishNamedObject:afterEncrypt");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        LOGGER_ERROR(logger, "Exception trying to encrypt: {0}", e.what());
+    }
+    catch (const std::string& s)
+    {
+        LOGGER_ERROR(logger, "Exception trying to encrypt: {0}", s);
+    }
+    catch (...)
+    {
+        LOGGER_ERROR(logger, "Unknown error trying to encrypt");
+    }
+
+    return false;
+}
+
+std::uint64_t PublicationDelegate::sealingEpoch()
+{
+    const auto epoch = sframe_context->currentEpoch();
+    if (!epoch) throw std::runtime_error("No epoch enabled");
+
+    if (*epoch != header_epoch)
+    {
+        // Buffers allocated from now on are laid out for the new header.
+        epoch_header = encodeEpoch(*epoch);
+        epoch_header_size = epoch_header.size();
+        header_epoch = *epoch;
+    }
+    return *epoch;
+}
+
+void PublicationDelegate::send(std::shared_ptr<quicr::Client> client,
+                               const quicr::Name& quicrName,
+                               std::uint8_t pri,
+                               std::uint16_t exp,
+                               quicr::bytes&& data,
+                               TraceBuffer&& trace)
+{
+    if (pacing)
+    {
+        const auto now = TokenBucket::Clock::now();
+        auto release_time = now;
         {
-            LOGGER_ERROR(logger, "Exception trying to encrypt: {0}", s);
-            return;
+            const std::lock_guard<std::mutex> _(pacing_mutex);
+            if (token_bucket) release_time = token_bucket->schedule(data.size(), now);
         }
-        catch (...)
+
+        // Objects already waiting go first, so this one queues behind them.
+        const auto paced_sender = release_time > now || paced_pending > 0 ? pacer.lock() : nullptr;
+        if (paced_sender)
         {
-            LOGGER_ERROR(logger, "Unknown error trying to encrypt");
+            ++paced_pending;
+            trace.add("qMediaDelegate:publishNamedObject:paced");
+            paced_sender->enqueue({
+                .release_time = release_time,
+                .queued_time = now,
+                .sequence = 0,
+                .publication = shared_from_this(),
+                .client = std::move(client),
+                .name = quicrName,
+                .priority = pri,
+                .expiry = exp,
+                .data = std::move(data),
+                .trace = std::move(trace),
+            });
             return;
         }
     }
+
+    transmit(client, quicrName, pri, exp, std::move(data), std::move(trace));
+}
+
+void PublicationDelegate::sendPaced(PacedObject&& object)
+{
+    const auto delay = std::chrono::duration_cast<std::chrono::microseconds>(TokenBucket::Clock::now()
+                                                                             - object.queued_time);
+    const auto delay_us = static_cast<std::uint64_t>(std::max<std::int64_t>(delay.count(), 0));
+    ++paced_count;
+    pacing_delay_total_us += delay_us;
+    auto max_us = pacing_delay_max_us.load();
+    while (delay_us > max_us && !pacing_delay_max_us.compare_exchange_weak(max_us, delay_us)) {}
+
+    if (removed)
+    {
+        buffer_pool->release(std::move(object.data));
+    }
     else
     {
-        to_publish = quicr::bytes(data, data + len);
+        transmit(object.client, object.name, object.priority, object.expiry, std::move(object.data), std::move(object.trace));
     }
 
+    // Only now may later objects of this publication skip the pacer.
+    --paced_pending;
+}
+
+void PublicationDelegate::transmit(const std::shared_ptr<quicr::Client>& client,
+                                   const quicr::Name& quicrName,
+                                   std::uint8_t pri,
+                                   std::uint16_t exp,
+                                   quicr::bytes&& data,
+                                   TraceBuffer&& trace)
+{
     try
     {
-        client->publishNamedObject(quicrName, pri, exp, std::move(to_publish), std::move(trace));
+        client->publishNamedObject(quicrName, pri, exp, std::move(data), trace.toTransport());
+        ++sent_count;
     }
     catch (const std::exception& e)
     {
         LOGGER_ERROR(logger, "Exception trying to publish: {0}", e.what());
-        return;
     }
     catch (const std::string& s)
     {
         LOGGER_ERROR(logger, "Exception trying to publish: {0}", s);
-        return;
     }
     catch (...)
     {
         LOGGER_ERROR(logger, "Unknown error trying publish");
-        return;
     }
 }
 }        // namespace qmedia
@@ -0,0 +1,92 @@
+#include "qmedia/ReorderBuffer.hpp"
+
+namespace qmedia
+{
+
+ReorderBuffer::ReorderBuffer(const ReorderBufferConfig& config) : config(config)
+{
+}
+
+void ReorderBuffer::push(std::uint32_t group_id,
+                         std::uint16_t object_id,
+                         std::uint8_t priority,
+                         quicr::bytes&& data,
+                         Clock::time_point now,
+                         std::vector<Object>& released)
+{
+    const auto object_key = key(group_id, object_id);
+    if (last_released && object_key <= *last_released)
+    {
+        late.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Fast path, nothing is waiting and the object is the one expected.
+    if (held.empty() && follows(object_key))
+    {
+        in_order.fetch_add(1, std::memory_order_relaxed);
+        release(object_key, {priority, std::move(data), now}, released);
+        return;
+    }
+
+    if (!held.try_emplace(object_key, HeldObject{priority, std::move(data), now}).second)
+    {
+        late.fetch_add(1, std::memory_order_relaxed);        // Already held, a duplicate
+        return;
+    }
+
+    flush(now, released);
+}
+
+void ReorderBuffer::flush(Clock::time_point now, std::vector<Object>& released)
+{
+    while (!held.empty())
+    {
+        auto first = held.begin();
+        if (!follows(first->first))
+        {
+            if (now - first->second.arrival < config.latency && held.size() <= config.max_objects) break;
+            gaps.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        reordered.fetch_add(1, std::memory_order_relaxed);
+        release(first->first, std::move(first->second), released);
+        held.erase(first);
+    }
+}
+
+ReorderBufferStats ReorderBuffer::getStats() const
+{
+    return {
+        .in_order = in_order.load(std::memory_order_relaxed),
+        .reordered = reordered.load(std::memory_order_relaxed),
+        .late = late.load(std::memory_order_relaxed),
+        .gaps = gaps.load(std::memory_order_relaxed),
+    };
+}
+
+bool ReorderBuffer::follows(std::uint64_t object_key) const
+{
+    // Nothing to order against before the first object.
+    if (!last_released) return true;
+
+    const auto group_id = object_key >> 16;
+    const auto object_id = object_key & 0xFFFF;
+    if (group_id == *last_released >> 16) return object_key == *last_released + 1;
+
+    return group_id > *last_released >> 16 && object_id == 0;
+}
+
+void ReorderBuffer::release(std::uint64_t object_key, HeldObject&& object, std::vector<Object>& released)
+{
+    last_released = object_key;
+    released.push_back({
+        .group_id = static_cast<std::uint32_t>(object_key >> 16),
+        .object_id = static_cast<std::uint16_t>(object_key),
+        .priority = object.priority,
+        .data = std::move(object.data),
+        .arrival = object.arrival,
+    });
+}
+
+}        // namespace qmedia
@@ -0,0 +1,125 @@
+#include "qmedia/WorkStealingPool.hpp"
+
+#include <algorithm>
+
+namespace qmedia
+{
+
+namespace
+{
+// Identifies the pool and queue of the current thread, if it is a pool thread.
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+}        // namespace
+
+WorkStealingPool::WorkStealingPool(std::size_t threads)
+{
+    threads = std::max<std::size_t>(threads, 1);
+    queues.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    this->threads.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        this->threads.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    stop();
+}
+
+void WorkStealingPool::submit(Task&& task)
+{
+    if (stopping) return;
+
+    const auto index = current_pool == this ? current_queue : next_queue++ % queues.size();
+    {
+        const std::lock_guard<std::mutex> _(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+
+    pending.fetch_add(1);
+    if (sleepers.load() > 0)
+    {
+        const std::lock_guard<std::mutex> _(sleep_mutex);
+        sleep_cv.notify_one();
+    }
+}
+
+void WorkStealingPool::stop()
+{
+    {
+        const std::lock_guard<std::mutex> _(sleep_mutex);
+        if (stopping.exchange(true)) return;
+    }
+    sleep_cv.notify_all();
+
+    for (auto& thread : threads)
+    {
+        if (thread.joinable()) thread.join();
+    }
+
+    for (auto& queue : queues)
+    {
+        const std::lock_guard<std::mutex> _(queue->mutex);
+        queue->tasks.clear();
+    }
+}
+
+bool WorkStealingPool::pop(std::size_t index, Task& task)
+{
+    // The owner takes the oldest task, keeping latency fair between submitters.
+    auto& queue = *queues[index];
+    const std::lock_guard<std::mutex> _(queue.mutex);
+    if (queue.tasks.empty()) return false;
+
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(std::size_t index, Task& task)
+{
+    // Thieves take from the back, away from where the owner is working.
+    for (std::size_t i = 1; i < queues.size(); ++i)
+    {
+        auto& queue = *queues[(index + i) % queues.size()];
+        const std::lock_guard<std::mutex> _(queue.mutex);
+        if (queue.tasks.empty()) continue;
+
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingPool::run(std::size_t index)
+{
+    current_pool = this;
+    current_queue = index;
+
+    while (!stopping)
+    {
+        Task task;
+        if (pop(index, task) || steal(index, task))
+        {
+            pending.fetch_sub(1);
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        ++sleepers;
+        sleep_cv.wait(lock, [&] { return stopping || pending.load() > 0; });
+        --sleepers;
+    }
+}
+
+}        // namespace qmedia
@@ -0,0 +1,81 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/BufferPool.hpp>
+
+using namespace qmedia;
+
+TEST_CASE("Buffer pool reuses released storage")
+{
+    auto pool = BufferPool({.size_classes = {64, 256}, .max_buffers_per_class = 2});
+
+    auto first = pool.acquire(100);
+    REQUIRE(first.size() == 100);
+    REQUIRE(first.capacity() >= 256);
+    const auto* storage = first.data();
+
+    pool.release(std::move(first));
+    auto second = pool.acquire(200);
+    REQUIRE(second.size() == 200);
+    REQUIRE(second.data() == storage);
+
+    const auto stats = pool.stats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.releases == 1);
+    REQUIRE(stats.pooled_bytes == 0);
+    REQUIRE(stats.high_water_bytes >= 256);
+}
+
+TEST_CASE("Buffer pool bypasses oversized and undersized buffers")
+{
+    auto pool = BufferPool({.size_classes = {64, 256}, .max_buffers_per_class = 2});
+
+    auto large = pool.acquire(1024);
+    REQUIRE(large.size() == 1024);
+    pool.release(quicr::bytes(8));
+
+    auto stats = pool.stats();
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.drops == 1);
+
+    // Storage far beyond the last class is not pooled...
+    pool.release(std::move(large));
+    stats = pool.stats();
+    REQUIRE(stats.releases == 0);
+    REQUIRE(stats.drops == 2);
+    REQUIRE(stats.pooled_bytes == 0);
+
+    // ...but a little slack still serves the largest class it covers.
+    auto slack = quicr::bytes();
+    slack.reserve(400);
+    pool.release(std::move(slack));
+    stats = pool.stats();
+    REQUIRE(stats.releases == 1);
+    REQUIRE(stats.pooled_bytes >= 400);
+}
+
+TEST_CASE("Buffer pool caps idle buffers per class")
+{
+    auto pool = BufferPool({.size_classes = {64}, .max_buffers_per_class = 1});
+
+    pool.release(pool.acquire(10));
+    pool.release(quicr::bytes(64));
+
+    const auto stats = pool.stats();
+    REQUIRE(stats.releases == 1);
+    REQUIRE(stats.drops == 1);
+}
+
+TEST_CASE("Buffer pool with no size classes never pools")
+{
+    auto pool = BufferPool({.size_classes = {}, .max_buffers_per_class = 8});
+
+    pool.release(pool.acquire(10));
+    const auto buffer = pool.acquire(10);
+    REQUIRE(buffer.size() == 10);
+
+    const auto stats = pool.stats();
+    REQUIRE(stats.hits == 0);
+    REQUIRE(stats.misses == 2);
+    REQUIRE(stats.drops == 1);
+}
@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/DuplicateFilter.hpp>
+
+using namespace qmedia;
+
+TEST_CASE("Duplicate filter drops objects seen before")
+{
+    auto filter = DuplicateFilter();
+    REQUIRE(filter.accept(5, 0));
+    REQUIRE(filter.accept(5, 1));
+    REQUIRE(filter.accept(6, 0));
+
+    // Replayed, including out of order.
+    REQUIRE_FALSE(filter.accept(5, 1));
+    REQUIRE_FALSE(filter.accept(6, 0));
+    REQUIRE_FALSE(filter.accept(5, 0));
+
+    // Late but new.
+    REQUIRE(filter.accept(5, 2));
+    REQUIRE(filter.accept(4, 7));
+
+    filter.reset();
+    REQUIRE(filter.accept(5, 1));
+}
+
+TEST_CASE("Duplicate filter slides over groups")
+{
+    auto filter = DuplicateFilter();
+    REQUIRE(filter.accept(10, 3));
+
+    // The slot of group 10 is reused by a group a window later.
+    const auto later = std::uint32_t(10 + DuplicateFilter::Window_Groups);
+    REQUIRE(filter.accept(later, 3));
+    REQUIRE_FALSE(filter.accept(later, 3));
+
+    // Group 10 has left the window, so a replay of it is dropped.
+    REQUIRE_FALSE(filter.accept(10, 3));
+    REQUIRE_FALSE(filter.accept(10, 4));
+    REQUIRE(filter.accept(11, 0));
+}
+
+TEST_CASE("Duplicate filter slides over the objects of long groups")
+{
+    auto filter = DuplicateFilter();
+
+    // Audio published without new groups counts objects far past the bitmap.
+    for (std::uint32_t object = 0; object < 2000; ++object)
+    {
+        REQUIRE(filter.accept(3, static_cast<std::uint16_t>(object)));
+    }
+    REQUIRE_FALSE(filter.accept(3, 1999));
+    REQUIRE_FALSE(filter.accept(3, 1999 - DuplicateFilter::Window_Objects + 1));
+
+    // Behind the bitmap is too old to tell.
+    REQUIRE_FALSE(filter.accept(3, 1999 - DuplicateFilter::Window_Objects));
+
+    // A group first seen late still takes earlier objects arriving after it.
+    REQUIRE(filter.accept(4, 1000));
+    REQUIRE(filter.accept(4, 999));
+    REQUIRE_FALSE(filter.accept(4, 999));
+}
+
+TEST_CASE("Duplicate filter follows wrapping and restarted group IDs")
+{
+    auto filter = DuplicateFilter();
+    REQUIRE(filter.accept(0xFFFFFFFF, 0));
+    REQUIRE(filter.accept(0, 0));
+    REQUIRE_FALSE(filter.accept(0xFFFFFFFF, 0));
+
+    // A publisher that restarts far behind is not mistaken for a replay.
+    REQUIRE(filter.accept(0 - DuplicateFilter::Restart_Groups, 0));
+    REQUIRE(filter.accept(1 - DuplicateFilter::Restart_Groups, 0));
+    REQUIRE_FALSE(filter.accept(1 - DuplicateFilter::Restart_Groups, 0));
+}
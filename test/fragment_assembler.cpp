@@ -0,0 +1,123 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/FragmentAssembler.hpp>
+
+using namespace qmedia;
+
+TEST_CASE("Fragment header round trip")
+{
+    const auto header = FragmentHeader{.object_length = 200000, .offset = 198800, .index = 166};
+    auto buffer = quicr::bytes(FragmentHeader::Size);
+    header.encode(buffer);
+
+    const auto decoded = FragmentHeader::decode(buffer);
+    REQUIRE(decoded.has_value());
+    REQUIRE(decoded->object_length == header.object_length);
+    REQUIRE(decoded->offset == header.offset);
+    REQUIRE(decoded->index == header.index);
+
+    REQUIRE_FALSE(FragmentHeader::decode(std::span<const std::uint8_t>(buffer).first(4)).has_value());
+}
+
+TEST_CASE("Fragment assembler reassembles out of order fragments")
+{
+    auto assembler = FragmentAssembler(std::make_shared<BufferPool>());
+    const auto object = quicr::bytes{1, 2, 3, 4, 5, 6, 7};
+    const auto fragment = [&](std::size_t index) {
+        return std::span<const std::uint8_t>(object).subspan(index * 3, std::min<std::size_t>(3, 7 - index * 3));
+    };
+
+    REQUIRE_FALSE(assembler.add(1, object.size(), 6, fragment(2)).has_value());
+    REQUIRE_FALSE(assembler.add(1, object.size(), 0, fragment(0)).has_value());
+
+    // A duplicate neither completes nor corrupts the object.
+    REQUIRE_FALSE(assembler.add(1, object.size(), 0, fragment(0)).has_value());
+    REQUIRE(assembler.inFlight() == 1);
+
+    const auto complete = assembler.add(1, object.size(), 3, fragment(1));
+    REQUIRE(complete.has_value());
+    REQUIRE(*complete == object);
+    REQUIRE(assembler.inFlight() == 0);
+}
+
+TEST_CASE("Fragment assembler bounds memory")
+{
+    auto assembler = FragmentAssembler(std::make_shared<BufferPool>(), {.max_objects = 2, .max_object_size = 16});
+    const auto fragment = quicr::bytes{0xAA, 0xBB};
+
+    REQUIRE_FALSE(assembler.add(1, 32, 0, fragment).has_value());        // Too large
+    REQUIRE_FALSE(assembler.add(1, 4, 3, fragment).has_value());         // Past the end
+    REQUIRE(assembler.inFlight() == 0);
+
+    REQUIRE_FALSE(assembler.add(1, 4, 0, fragment).has_value());
+    REQUIRE_FALSE(assembler.add(2, 4, 0, fragment).has_value());
+    REQUIRE_FALSE(assembler.add(3, 4, 0, fragment).has_value());
+    REQUIRE(assembler.inFlight() == 2);
+
+    // Object 1 was evicted to make room for object 3.
+    REQUIRE_FALSE(assembler.add(1, 4, 2, fragment).has_value());
+    REQUIRE(assembler.add(3, 4, 2, fragment).has_value());
+
+    // Object 2 made room for the second attempt at object 1.
+    const auto stats = assembler.getStats();
+    REQUIRE(stats.reassembled == 1);
+    REQUIRE(stats.abandoned == 2);
+}
+
+TEST_CASE("Fragment assembler reassembles transport fragments of unknown length")
+{
+    auto assembler = FragmentAssembler(std::make_shared<BufferPool>());
+    const auto object = quicr::bytes{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    const auto fragment = [&](std::size_t offset, std::size_t size) {
+        return std::span<const std::uint8_t>(object).subspan(offset, size);
+    };
+
+    // The buffer grows as later offsets arrive, the last fragment fixes the length.
+    REQUIRE_FALSE(assembler.addTransportFragment(7, 0, false, fragment(0, 2)).has_value());
+    REQUIRE_FALSE(assembler.addTransportFragment(7, 8, true, fragment(8, 2)).has_value());
+    REQUIRE_FALSE(assembler.addTransportFragment(7, 2, false, fragment(2, 3)).has_value());
+
+    // Nothing may land past the end once it is known.
+    REQUIRE_FALSE(assembler.addTransportFragment(7, 9, false, fragment(8, 2)).has_value());
+
+    const auto complete = assembler.addTransportFragment(7, 5, false, fragment(5, 3));
+    REQUIRE(complete.has_value());
+    REQUIRE(*complete == object);
+    REQUIRE(assembler.inFlight() == 0);
+    REQUIRE(assembler.bufferedBytes() == 0);
+}
+
+TEST_CASE("Fragment assembler abandons stale and oversized objects")
+{
+    using namespace std::chrono_literals;
+
+    const auto config = FragmentAssemblerConfig{
+        .max_objects = 8,
+        .max_object_size = 90,
+        .max_buffered_bytes = 100,
+        .timeout = 100ms,
+    };
+    auto assembler = FragmentAssembler(std::make_shared<BufferPool>(), config);
+    const auto fragment = quicr::bytes(40, 0xCC);
+    const auto now = FragmentAssembler::Clock::now();
+
+    REQUIRE_FALSE(assembler.addTransportFragment(1, 0, false, fragment, now).has_value());
+    REQUIRE_FALSE(assembler.addTransportFragment(2, 0, false, fragment, now + 10ms).has_value());
+    REQUIRE(assembler.bufferedBytes() == 80);
+
+    // Growing object 2 past the memory bound gives up on the older object 1.
+    REQUIRE_FALSE(assembler.addTransportFragment(2, 40, false, fragment, now + 20ms).has_value());
+    REQUIRE(assembler.inFlight() == 1);
+    REQUIRE(assembler.bufferedBytes() <= 100);
+
+    // Object 2 is never completed and times out when the next fragment arrives.
+    REQUIRE_FALSE(assembler.addTransportFragment(3, 0, false, fragment, now + 200ms).has_value());
+    REQUIRE(assembler.inFlight() == 1);
+
+    // Objects beyond the size limit are rejected outright.
+    REQUIRE_FALSE(assembler.addTransportFragment(4, 60, true, fragment, now + 200ms).has_value());
+
+    const auto stats = assembler.getStats();
+    REQUIRE(stats.reassembled == 0);
+    REQUIRE(stats.abandoned == 2);
+}
@@ -0,0 +1,102 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/GroupClock.hpp>
+
+using namespace qmedia;
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr auto Cadence = 33ms;
+constexpr auto Deadline = 500ms;
+
+/**
+ * @brief Delivers objects of consecutive groups at the cadence, returning the
+ *        group after the last one.
+ */
+std::uint32_t
+deliver_live(GroupClock& clock, std::uint32_t group_id, std::size_t groups, GroupClock::Clock::time_point& now)
+{
+    for (std::size_t group = 0; group < groups; ++group, ++group_id, now += Cadence)
+    {
+        for (auto offset : {0ms, 10ms, 20ms})
+        {
+            REQUIRE(clock.lateness(group_id, now + offset) <= 0ms);
+        }
+    }
+    return group_id;
+}
+}        // namespace
+
+TEST_CASE("Group clock knows nothing before the cadence")
+{
+    auto clock = GroupClock();
+    auto now = GroupClock::Clock::now();
+    REQUIRE(clock.lateness(7, now) == 0ms);
+    REQUIRE(clock.lateness(8, now + 10s) == 0ms);
+    REQUIRE(clock.lateness(3, now + 20s) == 0ms);
+}
+
+TEST_CASE("Group clock drops stale objects after a stall")
+{
+    auto clock = GroupClock();
+    auto now = GroupClock::Clock::now();
+    auto group_id = deliver_live(clock, 100, 20, now);
+
+    // Delivery stalls for a second, then the backlog arrives in a burst.
+    const auto stall = 1s;
+    const auto backlog = std::uint32_t(stall / Cadence);
+    auto arrival = now + stall;
+    auto expired = 0;
+    for (std::uint32_t group = 0; group < backlog; ++group, arrival += 1ms)
+    {
+        if (clock.lateness(group_id + group, arrival) > Deadline) ++expired;
+    }
+
+    // The groups due more than the deadline ago are stale.
+    const auto stale = std::uint32_t((stall - Deadline) / Cadence);
+    CHECK(expired >= int(stale) - 1);
+    CHECK(expired <= int(stale) + 1);
+
+    // Live again once caught up.
+    now += backlog * Cadence;
+    deliver_live(clock, group_id + backlog, 20, now);
+}
+
+TEST_CASE("Group clock follows a lasting delay")
+{
+    auto clock = GroupClock();
+    auto now = GroupClock::Clock::now();
+    auto group_id = deliver_live(clock, 0, 20, now);
+
+    // The path gets 300ms longer; the first group is late, later ones keep the pace.
+    now += 300ms;
+    REQUIRE(clock.lateness(group_id, now) < Deadline);
+    now += Cadence;
+    deliver_live(clock, group_id + 1, 20, now);
+}
+
+TEST_CASE("Group clock follows a slower cadence")
+{
+    auto clock = GroupClock();
+    auto now = GroupClock::Clock::now();
+    auto group_id = deliver_live(clock, 0, 20, now);
+
+    // Groups come less often, e.g. a lower frame rate.
+    for (std::size_t group = 0; group < 40; ++group, ++group_id, now += 3 * Cadence)
+    {
+        REQUIRE(clock.lateness(group_id, now) < Deadline);
+    }
+    REQUIRE(clock.lateness(group_id, now) <= 0ms);
+}
+
+TEST_CASE("Group clock starts over for a restarted publisher")
+{
+    auto clock = GroupClock();
+    auto now = GroupClock::Clock::now();
+    deliver_live(clock, 50000, 20, now);
+
+    // Restarted publishers go back to lower IDs.
+    REQUIRE(clock.lateness(10, now) == 0ms);
+    deliver_live(clock, 11, 20, now);
+}
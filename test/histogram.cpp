@@ -0,0 +1,44 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/Histogram.hpp>
+
+using namespace qmedia;
+
+TEST_CASE("Histogram buckets by power of two")
+{
+    auto histogram = Histogram();
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(3);
+    histogram.record(1000);
+    histogram.record(std::numeric_limits<std::uint64_t>::max() / 2);
+
+    const auto snapshot = histogram.snapshot();
+    REQUIRE(snapshot.count == 5);
+    REQUIRE(snapshot.buckets[0] == 1);
+    REQUIRE(snapshot.buckets[1] == 1);
+    REQUIRE(snapshot.buckets[2] == 1);
+    REQUIRE(snapshot.buckets[10] == 1);        // 512..1023
+    REQUIRE(snapshot.buckets[HistogramSnapshot::Bucket_Count - 1] == 1);
+
+    REQUIRE(snapshot.percentile(0.0) == 0);
+    REQUIRE(snapshot.percentile(0.6) == 3);
+    REQUIRE(snapshot.percentile(0.8) == 1023);
+    REQUIRE(snapshot.percentile(1.0) == std::numeric_limits<std::uint64_t>::max());
+}
+
+TEST_CASE("Histogram snapshots add up")
+{
+    auto first = Histogram();
+    auto second = Histogram();
+    first.record(10);
+    second.record(20);
+    second.record(30);
+
+    auto total = first.snapshot();
+    total += second.snapshot();
+    REQUIRE(total.count == 3);
+    REQUIRE(total.sum == 60);
+    REQUIRE(total.mean() == 20.0);
+    REQUIRE(HistogramSnapshot().percentile(0.5) == 0);
+}
@@ -0,0 +1,63 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/LayerAdaptation.hpp>
+
+using namespace qmedia;
+using namespace std::chrono_literals;
+
+namespace
+{
+const auto Layer_Bitrates = std::vector<std::uint32_t>{300, 1000, 3000};
+const auto Config = LayerAdaptationConfig{
+    .interval = 500ms,
+    .down_loss = 0.05,
+    .up_loss = 0.01,
+    .down_throughput = 0.5,
+    .down_samples = 2,
+    .up_hold = 10s,
+    .switch_timeout = 5s,
+};
+}        // namespace
+
+TEST_CASE("Layer adaptation steps down after sustained loss")
+{
+    auto now = LayerAdaptation::Clock::now();
+    auto adaptation = LayerAdaptation(Config, Layer_Bitrates, 2, now);
+
+    // A single lossy sample is not enough.
+    REQUIRE_FALSE(adaptation.update({.loss = 0.2, .throughput_kbps = 3000}, now += 500ms).has_value());
+    REQUIRE_FALSE(adaptation.update({.loss = 0.0, .throughput_kbps = 3000}, now += 500ms).has_value());
+    REQUIRE_FALSE(adaptation.update({.loss = 0.2, .throughput_kbps = 3000}, now += 500ms).has_value());
+    REQUIRE(adaptation.update({.loss = 0.2, .throughput_kbps = 3000}, now += 500ms) == 1u);
+    adaptation.switched(1, now);
+
+    // Starved of throughput counts as bad too.
+    REQUIRE_FALSE(adaptation.update({.loss = 0.0, .throughput_kbps = 400}, now += 500ms).has_value());
+    REQUIRE(adaptation.update({.loss = 0.0, .throughput_kbps = 400}, now += 500ms) == 0u);
+    adaptation.switched(0, now);
+
+    // Nothing lower than the lowest layer.
+    REQUIRE_FALSE(adaptation.update({.loss = 0.5, .throughput_kbps = 0}, now += 500ms).has_value());
+    REQUIRE_FALSE(adaptation.update({.loss = 0.5, .throughput_kbps = 0}, now += 500ms).has_value());
+}
+
+TEST_CASE("Layer adaptation steps up after a clean stretch, within the cap")
+{
+    auto now = LayerAdaptation::Clock::now();
+    auto adaptation = LayerAdaptation(Config, Layer_Bitrates, 0, now);
+    adaptation.setMaxLayer(1);
+
+    // Loss between the thresholds restarts the clean stretch.
+    REQUIRE_FALSE(adaptation.update({.loss = 0.0, .throughput_kbps = 300}, now += 9s).has_value());
+    REQUIRE_FALSE(adaptation.update({.loss = 0.03, .throughput_kbps = 300}, now += 500ms).has_value());
+    REQUIRE_FALSE(adaptation.update({.loss = 0.0, .throughput_kbps = 300}, now += 9s).has_value());
+    REQUIRE(adaptation.update({.loss = 0.0, .throughput_kbps = 300}, now += 1s) == 1u);
+    adaptation.switched(1, now);
+
+    // Capped at layer 1.
+    REQUIRE_FALSE(adaptation.update({.loss = 0.0, .throughput_kbps = 1000}, now += 60s).has_value());
+
+    // Lowering the cap below the current layer switches down straight away.
+    adaptation.setMaxLayer(0);
+    REQUIRE(adaptation.update({.loss = 0.0, .throughput_kbps = 1000}, now += 500ms) == 0u);
+}
@@ -0,0 +1,162 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/LossTracker.hpp>
+
+using namespace qmedia;
+using namespace std::chrono_literals;
+
+TEST_CASE("Loss tracker counts interleaved groups without loss")
+{
+    auto tracker = LossTracker();
+    auto now = LossTracker::Clock::now();
+    auto incomplete = std::vector<std::uint32_t>();
+
+    // Two groups on their own streams, arriving interleaved.
+    tracker.add(7, 0, now, incomplete);
+    tracker.add(8, 0, now, incomplete);
+    tracker.add(7, 1, now, incomplete);
+    tracker.add(8, 1, now, incomplete);
+    tracker.add(7, 2, now += 200ms, incomplete);
+
+    const auto stats = tracker.getStats();
+    REQUIRE(incomplete.empty());
+    CHECK(stats.groups == 2);
+    CHECK(stats.lost_objects == 0);
+    CHECK(stats.lost_groups == 0);
+    CHECK(stats.reordered == 0);
+}
+
+TEST_CASE("Loss tracker reports holes after the reorder window")
+{
+    auto tracker = LossTracker({.groups = 4, .reorder_window = 100ms});
+    auto now = LossTracker::Clock::now();
+    auto incomplete = std::vector<std::uint32_t>();
+
+    // The subscription starts mid-group, which is not a loss.
+    tracker.add(0xFFFFFFFF, 5, now, incomplete);
+    tracker.add(0xFFFFFFFF, 8, now, incomplete);
+    tracker.add(0xFFFFFFFF, 7, now += 50ms, incomplete);
+    REQUIRE(incomplete.empty());
+
+    // Object 6 is still missing after the window. Group IDs wrap.
+    tracker.add(0, 0, now += 60ms, incomplete);
+    REQUIRE(incomplete == std::vector<std::uint32_t>{0xFFFFFFFF});
+    incomplete.clear();
+
+    // It turns up after all.
+    tracker.add(0xFFFFFFFF, 6, now, incomplete);
+
+    // Group 1 never arrives, group 2 loses object 1.
+    tracker.add(2, 0, now, incomplete);
+    tracker.add(2, 2, now, incomplete);
+    tracker.add(2, 3, now += 100ms, incomplete);
+    REQUIRE(incomplete == std::vector<std::uint32_t>{1, 2});
+
+    const auto stats = tracker.getStats();
+    CHECK(stats.groups == 3);
+    CHECK(stats.lost_objects == 1);
+    CHECK(stats.lost_groups == 1);
+    CHECK(stats.recovered == 1);
+    CHECK(stats.incomplete_groups == 3);
+}
+
+TEST_CASE("Loss tracker settles groups leaving the window")
+{
+    auto tracker = LossTracker({.groups = 2, .reorder_window = 1s});
+    auto now = LossTracker::Clock::now();
+    auto incomplete = std::vector<std::uint32_t>();
+
+    tracker.add(1, 0, now, incomplete);
+    tracker.add(1, 2, now, incomplete);
+    tracker.add(2, 0, now, incomplete);
+    REQUIRE(incomplete.empty());
+
+    tracker.add(3, 0, now, incomplete);
+    REQUIRE(incomplete == std::vector<std::uint32_t>{1});
+
+    // Too old to tell.
+    tracker.add(1, 1, now, incomplete);
+    CHECK(tracker.getStats().recovered == 0);
+    CHECK(tracker.getStats().lost_objects == 1);
+}
+
+TEST_CASE("Loss tracker reports holes opening after their group was reported")
+{
+    auto tracker = LossTracker({.groups = 4, .reorder_window = 100ms});
+    auto now = LossTracker::Clock::now();
+    auto incomplete = std::vector<std::uint32_t>();
+
+    tracker.add(1, 0, now, incomplete);
+    tracker.add(1, 2, now, incomplete);
+    tracker.add(1, 3, now += 150ms, incomplete);
+    REQUIRE(incomplete == std::vector<std::uint32_t>{1});
+    incomplete.clear();
+
+    // Objects 4 and 5 go missing later in the same group.
+    tracker.add(1, 6, now, incomplete);
+    tracker.add(1, 1, now, incomplete);
+    tracker.add(1, 7, now += 150ms, incomplete);
+    REQUIRE(incomplete == std::vector<std::uint32_t>{1});
+
+    const auto stats = tracker.getStats();
+    CHECK(stats.lost_objects == 2);
+    CHECK(stats.recovered == 1);
+    CHECK(stats.reordered == 1);
+    CHECK(stats.incomplete_groups == 1);
+}
+
+TEST_CASE("Loss tracker counts an object seen twice once")
+{
+    auto tracker = LossTracker({.groups = 4, .reorder_window = 100ms});
+    auto now = LossTracker::Clock::now();
+    auto incomplete = std::vector<std::uint32_t>();
+
+    tracker.add(5, 0, now, incomplete);
+    tracker.add(5, 2, now, incomplete);
+    tracker.add(5, 2, now, incomplete);
+    tracker.add(5, 0, now, incomplete);
+    tracker.add(5, 3, now += 150ms, incomplete);
+    REQUIRE(incomplete == std::vector<std::uint32_t>{5});
+
+    const auto stats = tracker.getStats();
+    CHECK(stats.lost_objects == 1);
+    CHECK(stats.reordered == 0);
+}
+
+TEST_CASE("Loss tracker counts groups skipped beyond the window")
+{
+    auto tracker = LossTracker({.groups = 4, .reorder_window = 100ms});
+    auto now = LossTracker::Clock::now();
+    auto incomplete = std::vector<std::uint32_t>();
+
+    tracker.add(10, 0, now, incomplete);
+    tracker.add(100, 0, now, incomplete);
+    tracker.add(100, 1, now += 150ms, incomplete);
+
+    CHECK(tracker.getStats().lost_groups == 89);
+}
+
+TEST_CASE("Loss tracker starts over for a restarted publisher")
+{
+    auto tracker = LossTracker({.groups = 4, .reorder_window = 100ms});
+    auto now = LossTracker::Clock::now();
+    auto incomplete = std::vector<std::uint32_t>();
+
+    // Group IDs come from the clock, a restart after a pause jumps ahead.
+    tracker.add(1000, 0, now, incomplete);
+    tracker.add(1000, 1, now, incomplete);
+    tracker.add(1000 + 3600, 0, now += 10ms, incomplete);
+    tracker.add(1000 + 3600, 1, now += 150ms, incomplete);
+    CHECK(tracker.getStats().lost_groups == 0);
+
+    // And from a clock that went back, tracking goes on with the lower IDs.
+    tracker.add(2000, 0, now += 10ms, incomplete);
+    tracker.add(2001, 1, now += 10ms, incomplete);
+    tracker.add(2001, 2, now += 150ms, incomplete);
+
+    const auto stats = tracker.getStats();
+    CHECK(stats.lost_groups == 0);
+    CHECK(stats.lost_objects == 1);
+    CHECK(stats.groups == 4);
+    CHECK(incomplete == std::vector<std::uint32_t>{2001});
+}
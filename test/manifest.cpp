@@ -197,3 +197,26 @@ TEST_CASE("Manifest parsing")
     const auto actual_manifest_obj = json::parse(manifest_json).get<Manifest>();
     REQUIRE(actual_manifest_obj == expected_manifest_obj);
 }
+
+TEST_CASE("Quality profile parsing")
+{
+    const auto video = QualityProfile::parse("h264,width=1280,height=720,fps=30,br=1000");
+    REQUIRE(video.codec == "h264");
+    REQUIRE(video.width == 1280);
+    REQUIRE(video.height == 720);
+    REQUIRE(video.fps == 30);
+    REQUIRE(video.bitrate == 1000);
+
+    const auto audio = QualityProfile::parse("opus,br=6");
+    REQUIRE(audio.codec == "opus");
+    REQUIRE(audio.bitrate == 6);
+    REQUIRE(audio.fps == 0);
+
+    const auto fragmented = QualityProfile::parse("av1,br=4000,frag=1200");
+    REQUIRE(fragmented.fragment_size == 1200);
+    REQUIRE(video.fragment_size == 0);
+
+    const auto malformed = QualityProfile::parse("br=fast,fps=");
+    REQUIRE(malformed.codec.empty());
+    REQUIRE(malformed.bitrate == 0);
+}
@@ -0,0 +1,77 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/MPMCQueue.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace qmedia;
+
+TEST_CASE("MPMC queue is bounded and FIFO")
+{
+    auto queue = MPMCQueue<int>(3);
+    REQUIRE(queue.capacity() == 4);
+    REQUIRE(queue.empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        auto value = i;
+        REQUIRE(queue.push(std::move(value)));
+    }
+
+    auto overflow = 4;
+    REQUIRE_FALSE(queue.push(std::move(overflow)));
+    REQUIRE(overflow == 4);
+    REQUIRE(queue.size() == 4);
+
+    // Wrap around the ring a few times.
+    for (int i = 0; i < 16; ++i)
+    {
+        REQUIRE(queue.pop() == i);
+        auto value = i + 4;
+        REQUIRE(queue.push(std::move(value)));
+    }
+
+    for (int i = 16; i < 20; ++i)
+    {
+        REQUIRE(queue.pop() == i);
+    }
+    REQUIRE_FALSE(queue.pop().has_value());
+}
+
+TEST_CASE("MPMC queue hands every value to exactly one consumer")
+{
+    constexpr int count = 100000;
+    auto queue = MPMCQueue<int>(64);
+
+    // The producer makes room itself when the queue is full, like a drop
+    // oldest policy, while a consumer drains; values stay in order.
+    std::vector<int> dropped;
+    auto producer = std::thread([&] {
+        for (int i = 0; i < count; ++i)
+        {
+            auto value = i;
+            while (!queue.push(std::move(value)))
+            {
+                if (auto oldest = queue.pop()) dropped.push_back(*oldest);
+            }
+        }
+        auto done = -1;
+        while (!queue.push(std::move(done))) std::this_thread::yield();
+    });
+
+    std::vector<int> received;
+    while (true)
+    {
+        if (auto value = queue.pop())
+        {
+            if (*value < 0) break;
+            REQUIRE((received.empty() || *value > received.back()));
+            received.push_back(*value);
+        }
+    }
+    producer.join();
+
+    REQUIRE(received.size() + dropped.size() == count);
+    REQUIRE(queue.empty());
+}
@@ -0,0 +1,74 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/Pacer.hpp>
+
+using namespace qmedia;
+using namespace std::chrono_literals;
+
+namespace
+{
+bool near(TokenBucket::Clock::duration actual, std::chrono::microseconds expected)
+{
+    const auto error = actual - expected;
+    return error < 1us && error > -1us;
+}
+}        // namespace
+
+TEST_CASE("Token bucket releases a burst at once, then paces")
+{
+    // 100 kB/s with 10 ms of burst: 1000 bytes go out back to back.
+    auto bucket = TokenBucket(100000, 10ms);
+    const auto now = TokenBucket::Clock::now() + 1s;
+
+    REQUIRE(bucket.schedule(600, now) == now);
+    REQUIRE(bucket.schedule(400, now) == now);
+
+    // The bucket is empty, 1000 more bytes take 10 ms to be earned.
+    const auto first = bucket.schedule(1000, now);
+    REQUIRE(near(first - now, 10ms));
+
+    // Later objects queue up behind it, in order.
+    const auto second = bucket.schedule(500, now);
+    REQUIRE(near(second - now, 15ms));
+
+    // Once time has caught up, the bucket has refilled back to the burst.
+    const auto later = now + 1s;
+    REQUIRE(bucket.schedule(1000, later) == later);
+}
+
+TEST_CASE("Token bucket rate changes apply to later objects")
+{
+    auto bucket = TokenBucket(100000, 10ms);
+    const auto now = TokenBucket::Clock::now() + 1s;
+    REQUIRE(bucket.schedule(1000, now) == now);
+
+    bucket.setRate(50000);
+    REQUIRE(bucket.getRate() == 50000);
+    REQUIRE(near(bucket.schedule(500, now) - now, 10ms));
+}
+
+TEST_CASE("Token bucket keeps queued objects in order across rate changes")
+{
+    auto bucket = TokenBucket(100000, 10ms);
+    const auto now = TokenBucket::Clock::now() + 1s;
+    REQUIRE(bucket.schedule(1000, now) == now);
+
+    // Two objects queue up at the slow rate.
+    const auto first = bucket.schedule(1000, now);
+    const auto second = bucket.schedule(1000, now);
+    REQUIRE(near(second - now, 20ms));
+
+    // A faster rate would release the next one before them.
+    bucket.setRate(1000000);
+    const auto third = bucket.schedule(100, now + 1ms);
+    REQUIRE(first < second);
+    REQUIRE(third >= second);
+
+    // Without pacing, objects still wait for the ones queued before.
+    bucket.setRate(0);
+    REQUIRE(bucket.schedule(100, now + 2ms) == third);
+
+    // Once those went out, objects are sent right away.
+    const auto later = now + 1s;
+    REQUIRE(bucket.schedule(100, later) == later);
+}
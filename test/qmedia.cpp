@@ -9,6 +9,7 @@
 #include "relay.h"
 
 #include <set>
+#include <functional>
 #include <future>
 
 using namespace std::string_literals;
@@ -55,6 +56,8 @@ struct SubscriptionCollector
         return _objects;
     }
 
+    void add_batch() { ++batches; }
+
     void clear()
     {
         const auto _ = std::lock_guard(object_mutex);
@@ -80,6 +83,10 @@ struct SubscriptionCollector
     STRING_ACCESSOR(qualityProfile)
 #undef STRING_ACCESSOR
 
+    // Receive through subscribedObjects instead of subscribedObject.
+    std::atomic<bool> batched = false;
+    std::atomic<size_t> batches = 0;
+
 private:
     std::optional<std::string> _sourceId;
     std::optional<std::string> _label;
@@ -133,6 +140,18 @@ public:
         return 0;
     }
 
+    int subscribedObjects(const quicr::Namespace& quicrNamespace, std::span<qmedia::ObjectView> objects) override
+    {
+        if (!collector->batched) return QSubscriptionDelegate::subscribedObjects(quicrNamespace, objects);
+
+        collector->add_batch();
+        for (auto& object : objects)
+        {
+            collector->add_object(std::move(object.data));
+        }
+        return 0;
+    }
+
 private:
     std::shared_ptr<SubscriptionCollector> collector;
 };
@@ -198,7 +217,8 @@ static qmedia::QController make_controller(std::shared_ptr<SubscriptionCollector
     return qmedia::QController(sub, pub, logger, true, suite);
 }
 
-static qmedia::manifest::MediaStream make_media_stream(uint32_t endpoint_id)
+static qmedia::manifest::MediaStream make_media_stream(uint32_t endpoint_id,
+                                                       const std::string& qualityProfile = "opus,br=6")
 {
     const auto source_base = "source "s;
     const auto label_base = "Participant "s;
@@ -221,7 +241,7 @@ static qmedia::manifest::MediaStream make_media_stream(uint32_t endpoint_id)
                 .profiles =
                     {
                         {
-                            .qualityProfile = "opus,br=6",
+                            .qualityProfile = qualityProfile,
                             .quicrNamespace = encoder.EncodeUrl(url_base + endpoint_id_string),
                             .priorities = {1},
                             .expiry = {500,500},
@@ -243,7 +263,89 @@ static std::set<quicr::bytes> test_data(uint8_t label)
     return out;
 }
 
-static void two_party_session(bool encrypt)
+enum class PublishApi
+{
+    pointer,
+    span,
+    owned,
+    object_buffer,
+    batch,
+};
+
+static void publish(qmedia::QController& controller,
+                    const quicr::Namespace& quicrNamespace,
+                    const quicr::bytes& obj,
+                    PublishApi api)
+{
+    switch (api)
+    {
+        case PublishApi::pointer:
+            controller.publishNamedObject(quicrNamespace, obj.data(), obj.size(), false);
+            break;
+        case PublishApi::span:
+            controller.publishNamedObject(quicrNamespace, std::span<const uint8_t>(obj), false);
+            break;
+        case PublishApi::owned:
+            controller.publishNamedObject(quicrNamespace, quicr::bytes(obj), false);
+            break;
+        case PublishApi::object_buffer:
+        {
+            auto buffer = controller.allocateObjectBuffer(quicrNamespace, obj.size());
+            std::copy(obj.begin(), obj.end(), buffer.payload().begin());
+            controller.publishNamedObject(quicrNamespace, std::move(buffer), false);
+            break;
+        }
+        case PublishApi::batch:
+            // Batches are assembled by publish_all.
+            break;
+    }
+}
+
+static void publish_all(qmedia::QController& controller,
+                        const quicr::Namespace& quicrNamespace,
+                        const std::set<quicr::bytes>& objects,
+                        PublishApi api)
+{
+    if (api != PublishApi::batch)
+    {
+        for (const auto& obj : objects)
+        {
+            publish(controller, quicrNamespace, obj, api);
+        }
+        return;
+    }
+
+    // Publish in batches of 16, as a capture thread delivering bursts would.
+    const auto handle = controller.getPublicationHandle(quicrNamespace);
+    auto batch = std::vector<qmedia::PublishObject>{};
+    for (const auto& obj : objects)
+    {
+        batch.push_back({handle, obj, false});
+        if (batch.size() == 16)
+        {
+            controller.publishNamedObjects(batch);
+            batch.clear();
+        }
+    }
+    controller.publishNamedObjects(batch);
+}
+
+struct SessionOptions
+{
+    bool encrypt = true;
+    PublishApi api_a = PublishApi::pointer;        // How participant 1 publishes
+    PublishApi api_b = PublishApi::pointer;        // How participant 2 publishes
+    bool batched_delivery = false;                 // Receive through subscribedObjects
+    std::string quality_profile = "opus,br=6";     // Of both publications
+
+    // Applied to both controllers, before the manifest is imported.
+    std::function<void(qmedia::QController&)> configure = {};
+
+    // Applied to both controllers once they subscribed, before publishing.
+    std::function<void(qmedia::QController&)> rekey = {};
+};
+
+static void two_party_session(const SessionOptions& options)
 {
     // Start up a local relay
     const auto relay = LocalhostRelay();
@@ -251,10 +353,13 @@ static void two_party_session(bool encrypt)
 
     // Instantiate two QControllers
     auto collector_a = std::make_shared<SubscriptionCollector>();
-    auto controller_a = make_controller(collector_a, encrypt);
+    auto controller_a = make_controller(collector_a, options.encrypt);
 
     auto collector_b = std::make_shared<SubscriptionCollector>();
-    auto controller_b = make_controller(collector_b, encrypt);
+    auto controller_b = make_controller(collector_b, options.encrypt);
+
+    collector_a->batched = options.batched_delivery;
+    collector_b->batched = options.batched_delivery;
 
     // Connect to the relay
     qtransport::TransportConfig config{
@@ -264,9 +369,15 @@ static void two_party_session(bool encrypt)
     controller_a.connect("a@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
     controller_b.connect("a@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
 
+    if (options.configure)
+    {
+        options.configure(controller_a);
+        options.configure(controller_b);
+    }
+
     // Create and configure manifests
-    const auto media_a = make_media_stream(1);
-    const auto media_b = make_media_stream(2);
+    const auto media_a = make_media_stream(1, options.quality_profile);
+    const auto media_b = make_media_stream(2, options.quality_profile);
 
     const auto manifest_a = qmedia::manifest::Manifest{.subscriptions = {media_b}, .publications = {media_a}};
     controller_a.updateManifest(manifest_a);
@@ -286,13 +397,19 @@ static void two_party_session(bool encrypt)
      */
     std::this_thread::sleep_for(std::chrono::milliseconds(1000));
 
-    // Send media from participant 1 and verify that it arrived at the other participants
-    const auto sent_a = test_data(1);
-    for (const auto& obj : sent_a)
+    if (options.rekey)
     {
-        controller_a.publishNamedObject(ns_a, obj.data(), obj.size(), false);
+        options.rekey(controller_a);
+        options.rekey(controller_b);
+
+        // Keys are derived in the background and the replaced epochs retired.
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
     }
 
+    // Send media from participant 1 and verify that it arrived at the other participants
+    const auto sent_a = test_data(1);
+    publish_all(controller_a, ns_a, sent_a, options.api_a);
+
     const auto received_b = collector_b->await(sent_a.size());
 
     REQUIRE(sent_a == received_b);
@@ -300,12 +417,22 @@ static void two_party_session(bool encrypt)
     REQUIRE(collector_b->label() == "Participant 1");
     // REQUIRE(collector_b->qualityProfile() == "opus,br=6");
 
+    // Fragmented sessions count each fragment as an object.
+    const auto stats_b = controller_b.getSubscriptionStats(ns_a);
+    REQUIRE(stats_b.objects >= sent_a.size());
+    REQUIRE(stats_b.decrypt_failures == 0);
+    REQUIRE(stats_b.expired == 0);
+    REQUIRE(stats_b.duplicates == 0);
+    REQUIRE(stats_b.loss.incomplete_groups == 0);
+    REQUIRE(stats_b.bytes > 0);
+    REQUIRE(stats_b.object_size.count == stats_b.objects);
+    REQUIRE(stats_b.inter_arrival.count == stats_b.objects - 1);
+    REQUIRE(controller_b.getSourceStats("1").objects == stats_b.objects);
+    if (options.batched_delivery) REQUIRE(collector_b->batches > 0);
+
     // Send media from participant 2 and verify that it arrived at the other participants
     const auto sent_b = test_data(2);
-    for (const auto& obj : sent_b)
-    {
-        controller_b.publishNamedObject(ns_b, obj.data(), obj.size(), false);
-    }
+    publish_all(controller_b, ns_b, sent_b, options.api_b);
 
     const auto received_a = collector_a->await(sent_b.size());
     REQUIRE(sent_b == received_a);
@@ -316,8 +443,114 @@ static void two_party_session(bool encrypt)
 
 TEST_CASE("Two-party session")
 {
-    two_party_session(true);
-    two_party_session(false);
+    // Large enough queues that nothing is dropped.
+    const auto pipeline = [](qmedia::QController& controller) {
+        controller.setPublishPipeline({.worker_threads = 2, .queue_capacity = 512});
+    };
+
+    // Blocking on overflow, so every object still arrives in order.
+    const auto executor = [](qmedia::QController& controller) {
+        controller.setDeliveryExecutor({.threads = 2, .overflow_policy = qmedia::DeliveryOverflowPolicy::block});
+    };
+
+    const auto rekey = [](qmedia::QController& controller) {
+        controller.setEpochOverlap(std::chrono::milliseconds(50));
+        controller.installEpoch(2, quicr::bytes(32, 2));
+
+        // A larger epoch takes a longer header on the wire.
+        controller.installEpoch(1000, quicr::bytes(32, 3));
+    };
+
+    // Test objects are 4 bytes, so each one goes out as two uneven fragments.
+    const auto fragmented = "opus,br=6,frag=3";
+
+    using enum PublishApi;
+    struct Session
+    {
+        const char* name;
+        SessionOptions options;
+    };
+    const auto sessions = std::vector<Session>{
+        {"encrypted", {}},
+        {"unencrypted", {.encrypt = false}},
+        {"owned buffers", {.api_a = owned, .api_b = span}},
+        {"owned buffers, unencrypted", {.encrypt = false, .api_a = owned, .api_b = span}},
+        {"in-place encryption", {.api_a = object_buffer, .api_b = object_buffer}},
+        {"in-place, unencrypted", {.encrypt = false, .api_a = object_buffer, .api_b = pointer}},
+        {"batched publish", {.api_a = batch, .api_b = batch}},
+        {"batched publish, unencrypted", {.encrypt = false, .api_a = batch, .api_b = owned}},
+        {"publish pipeline", {.api_a = span, .api_b = object_buffer, .configure = pipeline}},
+        {"publish pipeline, unencrypted", {.encrypt = false, .api_a = batch, .api_b = owned, .configure = pipeline}},
+        {"fragmented objects", {.api_a = span, .api_b = object_buffer, .quality_profile = fragmented}},
+        {"fragmented, unencrypted",
+         {.encrypt = false, .api_a = owned, .api_b = pointer, .quality_profile = fragmented}},
+        {"fragmented pipeline",
+         {.api_a = batch, .api_b = object_buffer, .quality_profile = fragmented, .configure = pipeline}},
+        {"delivery executor", {.api_a = span, .api_b = owned, .configure = executor}},
+        {"delivery executor, unencrypted",
+         {.encrypt = false, .api_a = batch, .api_b = object_buffer, .configure = executor}},
+        {"batched delivery", {.api_a = batch, .api_b = span, .batched_delivery = true}},
+        {"batched delivery from the executor",
+         {.encrypt = false, .api_a = batch, .api_b = owned, .batched_delivery = true, .configure = executor}},
+        {"epoch rotations", {.api_a = span, .api_b = object_buffer, .rekey = rekey}},
+        {"epoch rotations, pipeline", {.api_a = owned, .api_b = object_buffer, .configure = pipeline, .rekey = rekey}},
+    };
+
+    for (const auto& session : sessions)
+    {
+        CAPTURE(session.name);
+        two_party_session(session.options);
+    }
+}
+
+TEST_CASE("Replaced epoch decrypts until its overlap ends")
+{
+    const auto relay = LocalhostRelay();
+    relay.run();
+
+    // Only the receiver rotates past epoch 2, the sender keeps using it.
+    auto collector_a = std::make_shared<SubscriptionCollector>();
+    auto sender = make_controller(collector_a);
+    auto collector_b = std::make_shared<SubscriptionCollector>();
+    auto receiver = make_controller(collector_b);
+
+    qtransport::TransportConfig config{
+        .tls_cert_filename = "",
+        .tls_key_filename = "",
+    };
+    sender.connect("a@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+    receiver.connect("b@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+
+    const auto media = make_media_stream(1);
+    sender.updateManifest({.subscriptions = {}, .publications = {media}});
+    receiver.updateManifest({.subscriptions = {media}, .publications = {}});
+    const auto quicrNamespace = media.profileSet.profiles[0].quicrNamespace;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+    sender.installEpoch(2, quicr::bytes(32, 2));
+    receiver.installEpoch(2, quicr::bytes(32, 2));
+    receiver.setEpochOverlap(std::chrono::milliseconds(800));
+    receiver.installEpoch(3, quicr::bytes(32, 3));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Within the overlap, objects of the replaced epoch still play.
+    const auto sent = test_data(1);
+    publish_all(sender, quicrNamespace, sent, PublishApi::span);
+    REQUIRE(collector_b->await(sent.size()) == sent);
+    REQUIRE(receiver.getSubscriptionStats(quicrNamespace).decrypt_failures == 0);
+
+    // Once it is evicted they no longer decrypt.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    publish_all(sender, quicrNamespace, test_data(3), PublishApi::span);
+
+    const auto deadline = std::chrono::steady_clock::now() + 1500ms;
+    while (receiver.getSubscriptionStats(quicrNamespace).decrypt_failures == 0
+           && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(receiver.getSubscriptionStats(quicrNamespace).decrypt_failures > 0);
+    REQUIRE(collector_b->await(sent.size()) == sent);
 }
 
 TEST_CASE("Fetch Switching Sets & Subscriptions")
@@ -461,6 +694,110 @@ TEST_CASE("Test Publication States")
     }
 }
 
+TEST_CASE("Publication handles")
+{
+    // Start up a local relay
+    const auto relay = LocalhostRelay();
+    relay.run();
+
+    auto controller_a = make_controller(std::make_shared<SubscriptionCollector>());
+    auto collector = std::make_shared<SubscriptionCollector>();
+    auto controller_b = make_controller(collector);
+
+    qtransport::TransportConfig config{
+        .tls_cert_filename = "",
+        .tls_key_filename = "",
+    };
+    controller_a.connect("a@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+    controller_b.connect("b@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+
+    const auto media = make_media_stream(1);
+    const quicr::Namespace& quicrNamespace = media.profileSet.profiles[0].quicrNamespace;
+
+    // No publication, no handle.
+    REQUIRE_FALSE(controller_a.getPublicationHandle(quicrNamespace).valid());
+
+    controller_a.updateManifest(qmedia::manifest::Manifest{.subscriptions = {}, .publications = {media}});
+    controller_b.updateManifest(qmedia::manifest::Manifest{.subscriptions = {media}, .publications = {}});
+
+    const auto handle = controller_a.getPublicationHandle(quicrNamespace);
+    REQUIRE(handle.valid());
+    REQUIRE(handle.quicrNamespace() == quicrNamespace);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+    const auto sent = test_data(1);
+    for (const auto& obj : sent)
+    {
+        controller_a.publishNamedObject(handle, std::span<const uint8_t>(obj), false);
+    }
+
+    const auto received = collector->await(sent.size());
+    REQUIRE(sent == received);
+
+    // Removing the publication from the manifest invalidates the handle, and
+    // publishing through it is a safe no-op.
+    controller_a.updateManifest(qmedia::manifest::Manifest{.subscriptions = {}, .publications = {}});
+    REQUIRE_FALSE(handle.valid());
+    REQUIRE(controller_a.getPublications().empty());
+    controller_a.publishNamedObject(handle, quicr::bytes{1, 2, 3}, false);
+}
+
+TEST_CASE("Paced publication")
+{
+    // Start up a local relay
+    const auto relay = LocalhostRelay();
+    relay.run();
+
+    auto controller_a = make_controller(std::make_shared<SubscriptionCollector>());
+    auto collector = std::make_shared<SubscriptionCollector>();
+    auto controller_b = make_controller(collector);
+
+    // The test stream is audio, which is only paced on request.
+    controller_a.setPacing({.pace_audio = true});
+
+    qtransport::TransportConfig config{
+        .tls_cert_filename = "",
+        .tls_key_filename = "",
+    };
+    controller_a.connect("a@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+    controller_b.connect("b@cisco.com", "127.0.0.1", LocalhostRelay::port, quicr::RelayInfo::Protocol::QUIC, 0, config);
+
+    const auto media = make_media_stream(1);
+    const quicr::Namespace& quicrNamespace = media.profileSet.profiles[0].quicrNamespace;
+    controller_a.updateManifest(qmedia::manifest::Manifest{.subscriptions = {}, .publications = {media}});
+    controller_b.updateManifest(qmedia::manifest::Manifest{.subscriptions = {media}, .publications = {}});
+
+    // Slow enough that a burst of objects is held back, fast enough for the test.
+    REQUIRE(controller_a.setPublicationBitrate(quicrNamespace, 200));
+    REQUIRE_FALSE(controller_b.setPublicationBitrate(quicrNamespace, 200));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+    const auto sent = test_data(1);
+    for (const auto& obj : sent)
+    {
+        controller_a.publishNamedObject(quicrNamespace, std::span<const uint8_t>(obj), false);
+    }
+
+    const auto received = collector->await(sent.size());
+    REQUIRE(sent == received);
+
+    // The pacer counts an object as sent once the transport returns, which
+    // may be after the subscriber already has it.
+    const auto deadline = std::chrono::steady_clock::now() + 1500ms;
+    auto stats = controller_a.getPublicationStats(quicrNamespace);
+    while ((stats.pacing_queue > 0 || stats.sent < sent.size()) && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        stats = controller_a.getPublicationStats(quicrNamespace);
+    }
+    REQUIRE(stats.sent == sent.size());
+    REQUIRE(stats.paced > 0);
+    REQUIRE(stats.pacing_queue == 0);
+    REQUIRE(stats.pacing_delay_max > std::chrono::microseconds::zero());
+}
+
 TEST_CASE("Subscription set/get state")
 {
     // Setup.
@@ -0,0 +1,83 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/ReorderBuffer.hpp>
+
+using namespace qmedia;
+using namespace std::chrono_literals;
+
+namespace
+{
+std::vector<std::pair<std::uint32_t, std::uint16_t>> ids(const std::vector<ReorderBuffer::Object>& objects)
+{
+    auto result = std::vector<std::pair<std::uint32_t, std::uint16_t>>();
+    for (const auto& object : objects) result.emplace_back(object.group_id, object.object_id);
+    return result;
+}
+}        // namespace
+
+TEST_CASE("Reorder buffer releases in order objects immediately")
+{
+    auto buffer = ReorderBuffer();
+    auto released = std::vector<ReorderBuffer::Object>();
+    const auto now = ReorderBuffer::Clock::now();
+
+    buffer.push(5, 0, 0, {1}, now, released);
+    buffer.push(5, 1, 0, {2}, now, released);
+    buffer.push(6, 0, 0, {3}, now, released);
+    REQUIRE(ids(released) == decltype(ids(released)){{5, 0}, {5, 1}, {6, 0}});
+    REQUIRE(released[2].data == quicr::bytes{3});
+    REQUIRE(buffer.size() == 0);
+    REQUIRE(buffer.getStats().in_order == 3);
+}
+
+TEST_CASE("Reorder buffer holds objects until the gap fills")
+{
+    auto buffer = ReorderBuffer({.latency = 50ms});
+    auto released = std::vector<ReorderBuffer::Object>();
+    const auto now = ReorderBuffer::Clock::now();
+
+    buffer.push(1, 0, 0, {}, now, released);
+    buffer.push(1, 2, 0, {}, now, released);
+    buffer.push(2, 0, 0, {}, now, released);
+    REQUIRE(released.size() == 1);
+    REQUIRE(buffer.size() == 2);
+
+    buffer.push(1, 1, 0, {}, now + 10ms, released);
+    REQUIRE(ids(released) == decltype(ids(released)){{1, 0}, {1, 1}, {1, 2}, {2, 0}});
+
+    // Anything at or before the last released object is too late.
+    buffer.push(1, 3, 0, {}, now + 20ms, released);
+    REQUIRE(released.size() == 4);
+
+    const auto& stats = buffer.getStats();
+    REQUIRE(stats.reordered == 3);
+    REQUIRE(stats.late == 1);
+    REQUIRE(stats.gaps == 0);
+}
+
+TEST_CASE("Reorder buffer gives up on missing objects after the latency target")
+{
+    auto buffer = ReorderBuffer({.latency = 50ms, .max_objects = 2});
+    auto released = std::vector<ReorderBuffer::Object>();
+    const auto now = ReorderBuffer::Clock::now();
+
+    buffer.push(1, 0, 0, {}, now, released);
+    buffer.push(1, 2, 0, {}, now, released);
+    buffer.push(1, 3, 0, {}, now + 10ms, released);
+
+    buffer.flush(now + 40ms, released);
+    REQUIRE(released.size() == 1);
+
+    // Object 1 never arrives; 2 and 3 follow once the wait expires.
+    buffer.flush(now + 50ms, released);
+    REQUIRE(ids(released) == decltype(ids(released)){{1, 0}, {1, 2}, {1, 3}});
+    REQUIRE(buffer.getStats().gaps == 1);
+
+    // Too many objects held releases past the gap without waiting.
+    buffer.push(1, 5, 0, {}, now + 60ms, released);
+    buffer.push(1, 6, 0, {}, now + 60ms, released);
+    buffer.push(1, 8, 0, {}, now + 60ms, released);
+    REQUIRE(ids(released).back() == std::pair<std::uint32_t, std::uint16_t>{1, 6});
+    REQUIRE(buffer.size() == 1);
+    REQUIRE(buffer.getStats().gaps == 2);
+}
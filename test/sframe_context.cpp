@@ -0,0 +1,133 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/QSFrameContext.hpp>
+
+using namespace qmedia;
+
+namespace
+{
+const auto Suite = sframe::CipherSuite::AES_GCM_128_SHA256;
+const auto Namespace = quicr::Namespace(quicr::Name(0xA11CE, 0x42), 80);
+
+// Encrypts and decrypts an object in place, true if it survived the trip.
+bool round_trip(QSFrameContext& sender, QSFrameContext& receiver, uint64_t epoch, sframe::Counter ctr)
+{
+    const auto plaintext = quicr::bytes(32, 0x5A);
+    auto buffer = plaintext;
+    buffer.resize(plaintext.size() + QSFrameContext::Max_Tag_Size);
+
+    const auto ciphertext = sender.protect(Namespace, ctr, buffer, plaintext.size());
+    const auto cleartext = receiver.unprotect(epoch, Namespace, ctr, ciphertext);
+    return quicr::bytes(cleartext.begin(), cleartext.end()) == plaintext;
+}
+}        // namespace
+
+TEST_CASE("SFrame keys are derived on first use and counted as cold")
+{
+    auto sender = QSFrameContext(Suite);
+    auto receiver = QSFrameContext(Suite);
+    for (auto* context : {&sender, &receiver})
+    {
+        context->addEpoch(1, quicr::bytes(16, 1));
+        context->enableEpoch(1);
+    }
+
+    REQUIRE(round_trip(sender, receiver, 1, 0));
+    CHECK(sender.getColdKeyMisses() == 1);
+    CHECK(receiver.getColdKeyMisses() == 1);
+
+    // Only the first object pays.
+    REQUIRE(round_trip(sender, receiver, 1, 1));
+    CHECK(sender.getColdKeyMisses() == 1);
+    CHECK(receiver.getColdKeyMisses() == 1);
+
+    // Keys of an epoch without a secret cannot be derived.
+    auto buffer = quicr::bytes(32 + QSFrameContext::Max_Tag_Size);
+    CHECK_THROWS(receiver.unprotect(2, Namespace, 0, buffer));
+}
+
+TEST_CASE("SFrame keys prepared ahead are not cold")
+{
+    auto sender = QSFrameContext(Suite);
+    auto receiver = QSFrameContext(Suite);
+    for (auto* context : {&sender, &receiver})
+    {
+        context->addEpoch(1, quicr::bytes(16, 1));
+        context->enableEpoch(1);
+        context->prepareKeys(Namespace);
+    }
+
+    REQUIRE(round_trip(sender, receiver, 1, 0));
+
+    // A new epoch is derived for the namespaces already in use.
+    for (auto* context : {&sender, &receiver})
+    {
+        context->addEpoch(2, quicr::bytes(16, 2));
+        context->enableEpoch(2);
+    }
+    REQUIRE(round_trip(sender, receiver, 2, 1));
+
+    CHECK(sender.getColdKeyMisses() == 0);
+    CHECK(receiver.getColdKeyMisses() == 0);
+}
+
+TEST_CASE("SFrame epochs can be removed and replaced")
+{
+    auto sender = QSFrameContext(Suite);
+    auto receiver = QSFrameContext(Suite);
+    for (auto* context : {&sender, &receiver})
+    {
+        context->addEpoch(1, quicr::bytes(16, 1));
+        context->addEpoch(2, quicr::bytes(16, 2));
+        context->enableEpoch(2);
+    }
+    REQUIRE(sender.currentEpoch() == 2u);
+    REQUIRE(round_trip(sender, receiver, 2, 0));
+
+    // A retired epoch no longer decrypts, the current one still does.
+    receiver.removeEpoch(1);
+    auto buffer = quicr::bytes(32 + QSFrameContext::Max_Tag_Size);
+    CHECK_THROWS(receiver.unprotect(1, Namespace, 1, buffer));
+    REQUIRE(round_trip(sender, receiver, 2, 2));
+
+    // Removing the current epoch stops encryption.
+    sender.removeEpoch(2);
+    CHECK_FALSE(sender.currentEpoch().has_value());
+    CHECK(sender.protect(Namespace, 3, buffer, 32).empty());
+
+    // Keys derived from a replaced secret are dropped with it.
+    sender.addEpoch(2, quicr::bytes(16, 3));
+    sender.enableEpoch(2);
+    receiver.addEpoch(2, quicr::bytes(16, 3));
+    REQUIRE(round_trip(sender, receiver, 2, 4));
+}
+
+TEST_CASE("SFrame keys go with the last user of their namespace")
+{
+    auto sender = QSFrameContext(Suite);
+    auto receiver = QSFrameContext(Suite);
+    for (auto* context : {&sender, &receiver})
+    {
+        context->addEpoch(1, quicr::bytes(16, 1));
+        context->enableEpoch(1);
+        context->retainNamespace(Namespace);
+        context->prepareKeys(Namespace);
+    }
+
+    // Another user still holds the namespace.
+    sender.retainNamespace(Namespace);
+    sender.releaseNamespace(Namespace);
+    REQUIRE(round_trip(sender, receiver, 1, 0));
+    CHECK(sender.getColdKeyMisses() == 0);
+
+    // Released keys are not derived for a new epoch either.
+    sender.releaseNamespace(Namespace);
+    for (auto* context : {&sender, &receiver})
+    {
+        context->addEpoch(2, quicr::bytes(16, 2));
+        context->enableEpoch(2);
+    }
+    REQUIRE(round_trip(sender, receiver, 2, 1));
+    CHECK(sender.getColdKeyMisses() == 1);
+    CHECK(receiver.getColdKeyMisses() == 0);
+}
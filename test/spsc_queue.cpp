@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/SPSCQueue.hpp>
+
+#include <thread>
+
+using namespace qmedia;
+
+TEST_CASE("SPSC queue is bounded and FIFO")
+{
+    auto queue = SPSCQueue<int>(3);
+    REQUIRE(queue.capacity() == 4);
+    REQUIRE(queue.empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        auto value = i;
+        REQUIRE(queue.push(std::move(value)));
+    }
+
+    auto overflow = 4;
+    REQUIRE_FALSE(queue.push(std::move(overflow)));
+    REQUIRE(queue.size() == 4);
+
+    // Wrap around the ring a few times.
+    for (int i = 0; i < 16; ++i)
+    {
+        REQUIRE(queue.pop() == i);
+        auto value = i + 4;
+        REQUIRE(queue.push(std::move(value)));
+    }
+
+    for (int i = 16; i < 20; ++i)
+    {
+        REQUIRE(queue.pop() == i);
+    }
+    REQUIRE_FALSE(queue.pop().has_value());
+}
+
+TEST_CASE("SPSC queue keeps order across threads")
+{
+    constexpr int count = 100000;
+    auto queue = SPSCQueue<int>(64);
+
+    auto producer = std::thread([&] {
+        for (int i = 0; i < count; ++i)
+        {
+            auto value = i;
+            while (!queue.push(std::move(value))) std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    while (expected < count)
+    {
+        if (auto value = queue.pop())
+        {
+            REQUIRE(*value == expected);
+            ++expected;
+        }
+    }
+
+    producer.join();
+    REQUIRE(queue.empty());
+}
@@ -0,0 +1,43 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/TraceBuffer.hpp>
+
+using namespace qmedia;
+
+TEST_CASE("Disabled trace only carries its start time")
+{
+    auto trace = TraceBuffer("start", false);
+    trace.add("ignored");
+    REQUIRE_FALSE(trace.isEnabled());
+
+    const auto items = trace.toTransport();
+    REQUIRE(items.size() == 1);
+    REQUIRE(items.front().start_time == trace.startTime());
+}
+
+TEST_CASE("Enabled trace records items up to its capacity")
+{
+    if (!TraceBuffer::Compiled) return;
+
+    auto trace = TraceBuffer("start", true);
+    trace.add("first");
+    trace.add("second");
+
+    auto items = trace.toTransport();
+    REQUIRE(items.size() == 3);
+    REQUIRE(items[0].method == "start");
+    REQUIRE(items[1].method == "first");
+    REQUIRE(items[2].method == "second");
+    REQUIRE(items[2].delta >= items[1].delta);
+    for (const auto& item : items)
+    {
+        REQUIRE(item.start_time == trace.startTime());
+    }
+
+    for (std::size_t i = 0; i < TraceBuffer::Capacity; ++i)
+    {
+        trace.add("overflow");
+    }
+    REQUIRE(trace.size() == TraceBuffer::Capacity);
+    REQUIRE(trace.toTransport().size() == TraceBuffer::Capacity);
+}
@@ -0,0 +1,76 @@
+#include <doctest/doctest.h>
+
+#include <qmedia/WorkStealingPool.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace qmedia;
+using namespace std::chrono_literals;
+
+namespace
+{
+template<typename Predicate>
+bool wait_for(Predicate&& predicate)
+{
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!predicate())
+    {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+}        // namespace
+
+TEST_CASE("Work-stealing pool runs every task")
+{
+    auto pool = WorkStealingPool(4);
+    REQUIRE(pool.size() == 4);
+
+    std::atomic<int> done = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.submit([&] { ++done; });
+    }
+
+    REQUIRE(wait_for([&] { return done == 1000; }));
+}
+
+TEST_CASE("Work-stealing pool spreads tasks queued by one thread")
+{
+    auto pool = WorkStealingPool(4);
+
+    // Every follow-up task lands on the submitting thread's own queue, so the
+    // blocked tasks only run concurrently if idle threads steal them.
+    std::atomic<int> running = 0;
+    std::atomic<int> max_running = 0;
+    std::atomic<int> done = 0;
+    pool.submit([&] {
+        for (int i = 0; i < 4; ++i)
+        {
+            pool.submit([&] {
+                const auto now = ++running;
+                auto seen = max_running.load();
+                while (now > seen && !max_running.compare_exchange_weak(seen, now)) {}
+                std::this_thread::sleep_for(50ms);
+                --running;
+                ++done;
+            });
+        }
+    });
+
+    REQUIRE(wait_for([&] { return done == 4; }));
+    REQUIRE(max_running > 1);
+}
+
+TEST_CASE("Work-stealing pool discards tasks after stop")
+{
+    auto pool = WorkStealingPool(1);
+    pool.stop();
+
+    std::atomic<int> done = 0;
+    pool.submit([&] { ++done; });
+    std::this_thread::sleep_for(10ms);
+    REQUIRE(done == 0);
+}